@@ -0,0 +1,73 @@
+/** PCAL6416A interrupt governor sample
+ *  
+ *  This sample code is showing interrupt load control with PCAL6416A.
+ *  Interrupts from all pins are enabled. A pin which interrupts 8 times in 10ms is masked 
+ *  until it becomes quiet for 100ms. Service passes are done at most once per 1ms.
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3P AND PCAL6xxx-ARD BOARDS, PIN10 MUST BE SHORTED TO PIN2 TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6416A:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/low-voltage-translating-16-bit-ic-bus-smbus-i-o-expander:PCAL6416A
+ */
+
+#include <PCAL6416A.h>
+#include <INT_GOVERNOR.h>
+
+PCAL6416A gpio;
+INT_GOVERNOR governor(gpio, 8, 10000, 100000, 1000);
+
+const uint8_t interruptPin = 2;
+
+void pin_int_callback() {
+  governor.interrupt();
+}
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+
+  Serial.println("\n***** Hello, INT_GOVERNOR! *****");
+
+  gpio.write_image(PULL_UD_EN, 0xFFFF);   //  Pull-up/down enabled
+  gpio.write_image(PULL_UD_SEL, 0xFFFF);  //  Pull-up selected
+
+  governor.begin(0xFFFF);
+
+  pinMode(interruptPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(interruptPin), pin_int_callback, FALLING);
+}
+
+void loop() {
+  static unsigned long last_print = 0;
+  uint64_t status = governor.service();
+
+  if (status) {
+    Serial.print("status = 0x");
+    Serial.print((uint32_t)status, HEX);
+    Serial.print(", levels = 0x");
+    Serial.println((uint32_t)governor.levels(), HEX);
+  }
+
+  if (1000 < millis() - last_print) {
+    last_print = millis();
+
+    Serial.print("interrupts = ");
+    Serial.print(governor.interrupts());
+    Serial.print(", passes = ");
+    Serial.print(governor.passes());
+    Serial.print(", masked = 0x");
+    Serial.print((uint32_t)governor.masked(), HEX);
+    Serial.print(", suppressed = ");
+    Serial.println(governor.suppressed());
+  }
+}
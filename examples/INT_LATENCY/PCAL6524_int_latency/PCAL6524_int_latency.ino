@@ -0,0 +1,75 @@
+/** PCAL6524 interrupt latency sample
+ *  
+ *  This sample code is showing interrupt latency measurement with PCAL6524 and QUAD_ENCODER.
+ *  Histograms are sent in CSV when 'd' is received from Serial: 
+ *    device, stage (0: ISR to read, 1: read, 2: read to dispatch, 3: total), counts of 16 bins
+ *
+ *  The library should be built with GPIO_NXP_INT_LATENCY defined (e.g. -DGPIO_NXP_INT_LATENCY in build flags). 
+ *  Without it, the instrumentation compiles to nothing.
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3P AND PCAL6xxx-ARD BOARDS, PIN10 MUST BE SHORTED TO PIN2 TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6524:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/ic-bus-controller-and-bridge-ics/ultra-low-voltage-translating-24-bit-fm-plus-ic-bus-smbus-i-o-expander:PCAL6524
+ */
+
+#include <PCAL6524.h>
+#include <QUAD_ENCODER.h>
+#include <INT_LATENCY.h>
+
+PCAL6524 gpio;
+QUAD_ENCODER encoder(gpio, 0x55);  //  Phase-A pins are port0 bit 0, 2, 4 and 6
+
+const uint8_t interruptPin = 2;
+volatile bool int_flag = false;
+
+void pin_int_callback() {
+  INT_LATENCY_ISR();
+  int_flag = true;
+}
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(115200);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+
+  Serial.println("\n***** Hello, INT_LATENCY! *****");
+
+#if !defined(GPIO_NXP_INT_LATENCY)
+  Serial.println("GPIO_NXP_INT_LATENCY is not defined. No measurement is done");
+#endif
+
+  gpio.write_port(PULL_UD_EN, (uint8_t)0xFF, 0);   //  Pull-up/down enabled for port0
+  gpio.write_port(PULL_UD_SEL, (uint8_t)0xFF, 0);  //  Pull-up selected for port0
+
+  encoder.begin();
+
+  pinMode(interruptPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(interruptPin), pin_int_callback, FALLING);
+}
+
+void loop() {
+  if (int_flag) {
+    int_flag = false;
+    encoder.service();
+  }
+
+#if defined(GPIO_NXP_INT_LATENCY)
+  if (Serial.available() && ('d' == Serial.read())) {
+    INT_LATENCY::export_csv(Serial);
+
+    Serial.print("total latency 99th percentile: ");
+    Serial.print(INT_LATENCY::percentile(&gpio, INT_LATENCY::TOTAL, 99.0));
+    Serial.println(" us");
+  }
+#endif
+}
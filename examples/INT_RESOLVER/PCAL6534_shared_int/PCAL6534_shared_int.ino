@@ -0,0 +1,69 @@
+/** Shared INT line sample
+ *  
+ *  This sample code is showing interrupt service for 2 devices sharing one INT line.
+ *  PCAL6534 (higher priority) and PCAL6524 have open-drain INT outputs wired together to the interrupt pin. 
+ *  Only unmasked pins can assert INT, and only devices which have unmasked pins are polled.
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3P AND PCAL6xxx-ARD BOARDS, PIN10 MUST BE SHORTED TO PIN2 TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <PCAL6524.h>
+#include <INT_RESOLVER.h>
+
+const uint8_t interruptPin = 2;
+
+PCAL6534 gpio0;
+PCAL6524 gpio1((0x44 >> 1) + 1);
+INT_RESOLVER resolver(interruptPin);
+
+volatile bool int_flag = false;
+
+void pin_int_callback() {
+  int_flag = true;
+}
+
+void changed(GPIO_base& gpio, uint64_t status, uint64_t levels) {
+  Serial.print(&gpio == &gpio0 ? "PCAL6534" : "PCAL6524");
+  Serial.print(": status = 0x");
+  Serial.print((uint32_t)status, HEX);
+  Serial.print(", levels = 0x");
+  Serial.println((uint32_t)levels, HEX);
+}
+
+void setup() {
+  gpio0.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+
+  Serial.println("\n***** Hello, INT_RESOLVER! *****");
+
+  resolver.add(gpio0, 1, changed);
+  resolver.add(gpio1, 0, changed);
+  resolver.begin();
+
+  //  All pins are masked after reset. Unmask port 0 of PCAL6534 and port 1 of PCAL6524
+  resolver.mask(gpio0, 0x0000FF, false);
+  resolver.mask(gpio1, 0x00FF00, false);
+
+  attachInterrupt(digitalPinToInterrupt(interruptPin), pin_int_callback, FALLING);
+}
+
+void loop() {
+  if (int_flag) {
+    int_flag = false;
+    resolver.service();
+  }
+}
@@ -0,0 +1,33 @@
+/** HD44780 character LCD sample
+ *  
+ *  This sample code is showing HD44780 compatible LCD operation through PCA9554.
+ *  The LCD is connected in 4-bit mode: 
+ *    bit0=RS, bit1=RW, bit2=E, bit3=backlight, bit4~7=D4~D7
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#include <PCA9554.h>
+#include <LCD_HD44780.h>
+
+PCA9554 gpio;
+LCD_HD44780 lcd(gpio);
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("\n***** Hello, LCD_HD44780! *****");
+
+  Wire.begin();
+
+  lcd.begin(16, 2);
+  lcd.print("Hello, PCA9554!");
+}
+
+void loop() {
+  lcd.set_cursor(0, 1);
+  lcd.print(millis() / 1000);
+  lcd.print(" sec");
+  delay(1000);
+}
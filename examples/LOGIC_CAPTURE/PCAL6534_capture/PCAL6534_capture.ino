@@ -0,0 +1,56 @@
+/** PCAL6534 logic capture sample
+ *  
+ *  This sample code is showing input capture with PCAL6534.
+ *  Inputs of all ports are sampled at the maximum bus rate for 1 second and changes are stored in a ring buffer.
+ *  Captured data is sent in binary format when 'd' is received from Serial.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <LOGIC_CAPTURE.h>
+
+PCAL6534 gpio;
+
+uint8_t ring[512];
+LOGIC_CAPTURE capture(ring, sizeof(ring));
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(115200);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+  Wire.setClock(1000000);  //  Fast-mode Plus
+
+  Serial.println("\n***** Hello, PCAL6534! *****");
+
+  capture.add(gpio);
+  capture.begin();
+  capture.capture(1000000);
+
+  Serial.print("samples: ");
+  Serial.println(capture.samples());
+  Serial.print("sample rate: ");
+  Serial.print(capture.sample_rate());
+  Serial.println(" samples/s");
+  Serial.print("compression ratio: ");
+  Serial.println(capture.compression_ratio());
+  Serial.print("ring usage: ");
+  Serial.print(capture.used());
+  Serial.print(" bytes, dropped records: ");
+  Serial.println(capture.dropped());
+  Serial.println("send 'd' to dump");
+}
+
+void loop() {
+  if (Serial.available() && ('d' == Serial.read()))
+    capture.export_binary(Serial);
+}
@@ -0,0 +1,60 @@
+/** PCAL6534 multiplexed 7-segment display sample
+ *  
+ *  This sample code is showing 4 digit multiplexed 7-segment LED display operation with PCAL6534.
+ *  Segments a~g and DP are connected to port0 bit0~7 (active HIGH).
+ *  Digit select (common cathode) are connected to port1 bit0~3 (active LOW).
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <MUX_DISPLAY.h>
+
+PCAL6534 gpio;
+
+const uint64_t digit_select[] = { 0x0100, 0x0200, 0x0400, 0x0800 };
+MUX_DISPLAY display(gpio, digit_select, 4, 0x00FF, 0x0F00);
+
+const uint8_t font[] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F };
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  Serial.println("\n***** Hello, PCAL6534! *****");
+
+  Wire.begin();
+
+  display.begin(100);
+  display.brightness(128);
+
+  Serial.print("max refresh rate at 400kHz: ");
+  Serial.println(display.max_rate(400000));
+}
+
+void loop() {
+  static unsigned long last = 0;
+  static int count = 0;
+
+  display.refresh();
+
+  if (100 < millis() - last) {
+    last = millis();
+    count++;
+
+    for (int i = 0, v = count; i < 4; i++, v /= 10)
+      display.set(3 - i, font[v % 10]);
+
+    display.swap();
+
+    if (!(count % 10)) {
+      Serial.print("refresh rate: ");
+      Serial.println(display.achieved_rate());
+    }
+  }
+}
@@ -0,0 +1,64 @@
+/** PCAL6534 scheduled output sample
+ *  
+ *  This sample code is showing time-triggered output with PCAL6534.
+ *  Pins on port 0 and port 1 change at given times. 
+ *  Changes in same 100us slot are sent in one burst. 
+ *  Jitter of the outputs is shown after each run.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <OUTPUT_SCHEDULER.h>
+
+PCAL6534 gpio;
+OUTPUT_SCHEDULER scheduler(100);
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  Serial.println("\n***** Hello, OUTPUT_SCHEDULER! *****");
+
+  Wire.begin();
+  Wire.setClock(400000);
+
+  gpio.write_image(OUT, 0);
+  gpio.write_image(CONFIG, ~0xFFFFULL);  //  port 0 and 1 as output
+
+  //  Pulses on pin 0 and pin 8 rise together and fall at different times
+  scheduler.event(gpio, 0x0001, 0x0001, 1000);
+  scheduler.event(gpio, 0x0100, 0x0100, 1020);  //  in same slot: sent in same burst
+  scheduler.event(gpio, 0x0001, 0x0000, 2000);
+  scheduler.event(gpio, 0x0100, 0x0000, 3500);
+
+  //  Short burst on pin 1 to 3
+  for (int i = 0; i < 3; i++) {
+    scheduler.event(gpio, 0x0002 << i, 0xFFFF, 5000 + i * 500);
+    scheduler.event(gpio, 0x0002 << i, 0x0000, 5250 + i * 500);
+  }
+
+  Serial.print("transfers = ");
+  Serial.println(scheduler.prepare(400000));
+}
+
+void loop() {
+  scheduler.start();
+
+  while (scheduler.busy())
+    scheduler.run();
+
+  Serial.print("jitter (us): max = ");
+  Serial.print(scheduler.max_jitter());
+  Serial.print(", min = ");
+  Serial.print(scheduler.min_jitter());
+  Serial.print(", average = ");
+  Serial.println(scheduler.average_jitter());
+
+  delay(1000);
+}
@@ -0,0 +1,81 @@
+/** PCAL9722 GPIO operation sample
+ *  
+ *  This sample code is showing four PCAL9722s on a shared CS.
+ *  Devices are distinguished by device address (A1/A0 pins) in the SPI frame.
+ *  Output writes and input reads of all devices are done in one SPI transaction.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL9722:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/22-bit-spi-i-o-expander-with-agile-i-o-features:PCAL9722
+ */
+
+#include <PCAL9722.h>
+
+const int CS_PIN    = 10;
+const int RESET_PIN = 9;
+
+PCAL9722 gpio0(SPI, CS_PIN, RESET_PIN, (0x40 >> 1) + 0);
+PCAL9722 gpio1(SPI, CS_PIN, -1, (0x40 >> 1) + 1);
+PCAL9722 gpio2(SPI, CS_PIN, -1, (0x40 >> 1) + 2);
+PCAL9722 gpio3(SPI, CS_PIN, -1, (0x40 >> 1) + 3);
+
+PCAL9722* gpio[] = { &gpio0, &gpio1, &gpio2, &gpio3 };
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  SPI.begin();
+  gpio0.begin();  //  Set CS pin and reset all devices
+
+  Serial.println("\n***** Hello, PCAL9722! *****");
+
+  uint8_t io_config[] = {
+    0x00,  // Configure port0 as OUTPUT
+    0x00,  // Configure port1 as OUTPUT
+    0x3F,  // Configure port2 bit 5~0 as INTPUT
+  };
+
+  for (int i = 0; i < 4; i++) {
+    gpio[i]->config(io_config);
+
+    if (i)
+      gpio[i]->group(gpio0);  //  Frames of gpio1~3 are queued in gpio0's pipeline
+  }
+}
+
+void loop() {
+  static int count = 0;
+  uint8_t out[4][3];
+  uint8_t in[4][3];
+
+  for (int i = 0; i < 4; i++) {
+    out[i][0] = count + i;
+    out[i][1] = 1 << ((count + i) & 0x7);
+    out[i][2] = 0x00;
+  }
+
+  gpio0.begin_pipeline();
+
+  for (int i = 0; i < 4; i++)
+    gpio[i]->write_port(OUT, out[i]);
+
+  for (int i = 0; i < 4; i++)
+    gpio[i]->read_port(IN, in[i]);
+
+  gpio0.end_pipeline();  //  8 frames in one SPI transaction
+
+  for (int i = 0; i < 4; i++) {
+    Serial.print(" 0x");
+    Serial.print(in[i][2] & 0x3F, HEX);
+  }
+
+  Serial.println("");
+
+  count++;
+  delay(50);
+}
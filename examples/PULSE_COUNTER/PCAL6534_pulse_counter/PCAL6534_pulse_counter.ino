@@ -0,0 +1,77 @@
+/** PCAL6534 pulse counter sample
+ *  
+ *  This sample code is showing edge counting and frequency measurement on all 34 pins of PCAL6534.
+ *  Rising edges are counted on all pins. Falling edges are also counted on port 0. 
+ *  Counts and frequencies (1 second gate) of pins which had edges are shown every second.
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3P AND PCAL6xxx-ARD BOARDS, PIN10 MUST BE SHORTED TO PIN2 TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <PULSE_COUNTER.h>
+
+PCAL6534 gpio;
+PULSE_COUNTER counter(gpio, 0x3FFFFFFFFULL, 0xFF);
+
+const uint8_t interruptPin = 2;
+volatile bool int_flag = false;
+
+void pin_int_callback() {
+  int_flag = true;
+}
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+  Wire.setClock(1000000);
+
+  Serial.println("\n***** Hello, PULSE_COUNTER! *****");
+
+  gpio.write_image(PULL_UD_EN, 0x3FFFFFFFFULL);   //  Pull-up/down enabled
+  gpio.write_image(PULL_UD_SEL, 0x3FFFFFFFFULL);  //  Pull-up selected
+
+  counter.frequency_gate(1000000);
+  counter.begin();
+
+  pinMode(interruptPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(interruptPin), pin_int_callback, FALLING);
+}
+
+void loop() {
+  static unsigned long last_print = 0;
+
+  if (int_flag) {
+    int_flag = false;
+    counter.service();
+  }
+
+  if (1000 < millis() - last_print) {
+    last_print = millis();
+
+    for (int pin = 0; pin < 34; pin++) {
+      if (!counter.count(pin))
+        continue;
+
+      Serial.print("pin ");
+      Serial.print(pin);
+      Serial.print(": ");
+      Serial.print(counter.count(pin));
+      Serial.print(" edges, ");
+      Serial.print(counter.frequency(pin));
+      Serial.println(" Hz");
+    }
+  }
+}
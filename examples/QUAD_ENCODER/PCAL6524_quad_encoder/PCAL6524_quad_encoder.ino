@@ -0,0 +1,74 @@
+/** PCAL6524 quadrature encoder sample
+ *  
+ *  This sample code is showing quadrature encoder decoding with PCAL6524.
+ *  4 encoders are connected to port0: phase-A on bit 0, 2, 4, 6 and phase-B on bit 1, 3, 5, 7
+ *
+ *  *** IMPORTANT ***
+ *  *** TO RUN THIS SKETCH ON ARDUINO UNO R3P AND PCAL6xxx-ARD BOARDS, PIN10 MUST BE SHORTED TO PIN2 TO HANDLE INTERRUPT CORRECTLY
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6524:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/ic-bus-controller-and-bridge-ics/ultra-low-voltage-translating-24-bit-fm-plus-ic-bus-smbus-i-o-expander:PCAL6524
+ */
+
+#include <PCAL6524.h>
+#include <QUAD_ENCODER.h>
+
+PCAL6524 gpio;
+QUAD_ENCODER encoder(gpio, 0x55);  //  Phase-A pins are port0 bit 0, 2, 4 and 6
+
+const uint8_t interruptPin = 2;
+volatile bool int_flag = false;
+
+void pin_int_callback() {
+  int_flag = true;
+}
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  while (!Serial)
+    ;
+
+  Wire.begin();
+
+  Serial.println("\n***** Hello, PCAL6524! *****");
+
+  gpio.write_port(PULL_UD_EN, (uint8_t)0xFF, 0);   //  Pull-up/down enabled for port0
+  gpio.write_port(PULL_UD_SEL, (uint8_t)0xFF, 0);  //  Pull-up selected for port0
+
+  encoder.begin();
+
+  Serial.print("max step rate at 400kHz: ");
+  Serial.println(encoder.max_step_rate(400000));
+
+  pinMode(interruptPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(interruptPin), pin_int_callback, FALLING);
+}
+
+void loop() {
+  static unsigned long last_print = 0;
+
+  if (int_flag) {
+    int_flag = false;
+    encoder.service();
+  }
+
+  if (200 < millis() - last_print) {
+    last_print = millis();
+
+    for (int i = 0; i < encoder.count(); i++) {
+      Serial.print(encoder.position(i));
+      Serial.print(" (");
+      Serial.print(encoder.velocity(i));
+      Serial.print("/s, missed ");
+      Serial.print(encoder.missed(i));
+      Serial.print(")  ");
+    }
+    Serial.println("");
+  }
+}
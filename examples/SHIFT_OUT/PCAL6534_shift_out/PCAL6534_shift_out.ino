@@ -0,0 +1,53 @@
+/** PCAL6534 shift register sample
+ *  
+ *  This sample code is showing 3 chains of 74HC595 driven in parallel through port 1 of PCAL6534.
+ *  Pins of port 1 are used as: 
+ *    bit0=data of chain 0, bit3=data of chain 1, bit6=data of chain 2, bit1=SHCP (clock), bit7=STCP (latch)
+ *  Each chain has 2 shift registers. A bit moves on the outputs of each chain.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <SHIFT_OUT.h>
+
+PCAL6534 gpio;
+SHIFT_OUT chains(gpio, 1, 0x49, 1, 7);
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  Serial.println("\n***** Hello, SHIFT_OUT! *****");
+
+  Wire.begin();
+  chains.begin();
+
+  Serial.print("channels = ");
+  Serial.println(chains.channels());
+  Serial.print("bit rate @400kHz = ");
+  Serial.print(chains.bit_rate(400000));
+  Serial.println(" bps/channel");
+}
+
+void loop() {
+  static int count = 0;
+  uint8_t data[2 * 3];  //  2 bytes for each of 3 chains, first byte goes to far end of the chain
+  uint16_t pattern;
+
+  for (int c = 0; c < 3; c++) {
+    pattern = 1 << ((count + c * 5) % 16);
+    data[0 * 3 + c] = pattern >> 8;
+    data[1 * 3 + c] = pattern;
+  }
+
+  chains.write(data, 2);
+
+  count++;
+  delay(100);
+}
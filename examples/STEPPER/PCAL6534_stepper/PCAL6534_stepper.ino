@@ -0,0 +1,62 @@
+/** PCAL6534 stepper motor sample
+ *  
+ *  This sample code is showing 2 unipolar stepper motors driven through PCAL6534 (with ULN2003 or similar drivers).
+ *    Motor 0: pin 0~3 (port 0) in full step
+ *    Motor 1: pin 4~7 (port 0) in half step
+ *  Phase bits of both motors are written together only when they change.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <STEPPER.h>
+
+PCAL6534 gpio;
+STEPPER steppers(gpio, 500);  //  500us tick
+
+int m0;
+int m1;
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  Serial.println("\n***** Hello, STEPPER! *****");
+
+  Wire.begin();
+  Wire.setClock(400000);
+
+  m0 = steppers.add(0, 1, 2, 3, STEPPER::FULL);
+  m1 = steppers.add(4, 5, 6, 7, STEPPER::HALF);
+  steppers.begin();
+
+  steppers.speed(m0, 500, 1000);  //  500 steps/s, 1000 steps/s^2
+  steppers.speed(m1, 800, 2000);
+
+  Serial.print("max step rate @400kHz = ");
+  Serial.print(steppers.max_step_rate(400000));
+  Serial.println(" steps/s");
+}
+
+void loop() {
+  static int32_t dir = 1;
+
+  steppers.move(m0, dir * 2048);
+  steppers.move(m1, -dir * 4096);
+
+  while (steppers.busy())
+    steppers.run();
+
+  Serial.print("position: ");
+  Serial.print(steppers.position(m0));
+  Serial.print(", ");
+  Serial.println(steppers.position(m1));
+
+  dir = -dir;
+  delay(500);
+}
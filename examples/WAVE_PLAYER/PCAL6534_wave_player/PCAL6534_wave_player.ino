@@ -0,0 +1,59 @@
+/** PCAL6534 waveform playback sample
+ *  
+ *  This sample code is showing waveform playback from flash with PCAL6534.
+ *  A test vector table in PROGMEM is played on port 0 each time pin 8 (port 1, bit 0) goes LOW. 
+ *  Records with '0' delay are sent in bursts at the bus speed.
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *  About PCAL6534:
+ *    https://www.nxp.com/products/interfaces/ic-spi-i3c-interface-devices/general-purpose-i-o-gpio/ultra-low-voltage-level-translating-34-bit-ic-bus-smbus-i-o-expander:PCAL6534
+ */
+
+#include <PCAL6534.h>
+#include <WAVE_PLAYER.h>
+
+//  delay (2 bytes, little endian, in microseconds), port 0 image
+const uint8_t vectors[] PROGMEM = {
+  0x00, 0x00, 0x01,  //  walking one at bus speed
+  0x00, 0x00, 0x02,
+  0x00, 0x00, 0x04,
+  0x00, 0x00, 0x08,
+  0x00, 0x00, 0x10,
+  0x00, 0x00, 0x20,
+  0x00, 0x00, 0x40,
+  0xE8, 0x03, 0x80,  //  hold 1ms
+  0xE8, 0x03, 0xFF,  //  hold 1ms
+  0x00, 0x00, 0x00,
+};
+
+PCAL6534 gpio;
+WAVE_PLAYER player(gpio, vectors, sizeof(vectors) / 3);
+
+void setup() {
+  gpio.begin(GPIO_base::ARDUINO_SHIELD);  //  Force ADR pin (@D8) LOW and reset to give right target address
+
+  Serial.begin(9600);
+  Serial.println("\n***** Hello, WAVE_PLAYER! *****");
+
+  Wire.begin();
+  Wire.setClock(400000);
+
+  player.begin();
+
+  Serial.print("max record rate @400kHz = ");
+  Serial.print(player.max_rate(400000));
+  Serial.println(" records/s");
+
+  player.arm(0x100, 0x000);  //  start when pin 8 is LOW
+}
+
+void loop() {
+  if (!player.run()) {
+    Serial.println("played");
+    delay(500);
+    player.arm(0x100, 0x000);
+  }
+}
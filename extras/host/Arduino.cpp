@@ -0,0 +1,216 @@
+#include "Arduino.h"
+
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+
+static const std::chrono::steady_clock::time_point	start_time	= std::chrono::steady_clock::now();
+
+HardwareSerial	Serial;
+
+unsigned long millis( void )
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start_time ).count();
+}
+
+unsigned long micros( void )
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start_time ).count();
+}
+
+void delay( unsigned long ms )
+{
+	std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+}
+
+void delayMicroseconds( unsigned int us )
+{
+	std::this_thread::sleep_for( std::chrono::microseconds( us ) );
+}
+
+void yield( void )
+{
+	std::this_thread::yield();
+}
+
+void pinMode( int, int )
+{
+}
+
+static const int	N_PINS	= 64;
+static uint64_t		low_pins	= 0;
+
+void digitalWrite( int pin, int value )
+{
+	if ( (pin < 0) || (N_PINS <= pin) )
+		return;
+
+	low_pins	= value ? (low_pins & ~(1ULL << pin)) : (low_pins | (1ULL << pin));
+}
+
+int digitalRead( int pin )
+{
+	if ( (pin < 0) || (N_PINS <= pin) )
+		return HIGH;
+
+	return (low_pins >> pin) & 1 ? LOW : HIGH;
+}
+
+int digitalPinToInterrupt( int pin )
+{
+	return pin;
+}
+
+void attachInterrupt( int, void (*)( void ), int )
+{
+}
+
+void noInterrupts( void )
+{
+}
+
+void interrupts( void )
+{
+}
+
+/* ******** HardwareSerial ******** */
+
+void HardwareSerial::begin( unsigned long )
+{
+}
+
+int HardwareSerial::available( void )
+{
+	return 0;
+}
+
+int HardwareSerial::read( void )
+{
+	return -1;
+}
+
+size_t HardwareSerial::write( uint8_t c )
+{
+	return (EOF == putchar( c )) ? 0 : 1;
+}
+
+size_t HardwareSerial::write( const uint8_t* buffer, size_t size )
+{
+	return fwrite( buffer, 1, size, stdout );
+}
+
+/* ******** Print ******** */
+
+size_t Print::write( const uint8_t* buffer, size_t size )
+{
+	size_t	n	= 0;
+
+	while ( size-- )
+		n	+= write( *buffer++ );
+
+	return n;
+}
+
+size_t Print::write( const char* str )
+{
+	return str ? write( (const uint8_t*)str, strlen( str ) ) : 0;
+}
+
+size_t Print::print( const char* s )
+{
+	return write( s );
+}
+
+size_t Print::print( char c )
+{
+	return write( (uint8_t)c );
+}
+
+size_t Print::print( int n, int base )
+{
+	return print( (long)n, base );
+}
+
+size_t Print::print( unsigned int n, int base )
+{
+	return print( (unsigned long)n, base );
+}
+
+size_t Print::print( long n, int base )
+{
+	if ( (n < 0) && (DEC == base) )
+		return print( '-' ) + number( -(unsigned long)n, base );
+
+	return number( n, base );
+}
+
+size_t Print::print( unsigned long n, int base )
+{
+	return number( n, base );
+}
+
+size_t Print::print( double n, int digits )
+{
+	char	s[ 32 ];
+
+	snprintf( s, sizeof( s ), "%.*f", digits, n );
+
+	return write( s );
+}
+
+size_t Print::println( void )
+{
+	return write( "\r\n" );
+}
+
+size_t Print::println( const char* s )
+{
+	return print( s ) + println();
+}
+
+size_t Print::println( char c )
+{
+	return print( c ) + println();
+}
+
+size_t Print::println( int n, int base )
+{
+	return print( n, base ) + println();
+}
+
+size_t Print::println( unsigned int n, int base )
+{
+	return print( n, base ) + println();
+}
+
+size_t Print::println( long n, int base )
+{
+	return print( n, base ) + println();
+}
+
+size_t Print::println( unsigned long n, int base )
+{
+	return print( n, base ) + println();
+}
+
+size_t Print::println( double n, int digits )
+{
+	return print( n, digits ) + println();
+}
+
+size_t Print::number( unsigned long n, int base )
+{
+	char	s[ sizeof( n ) * 8 + 1 ];
+	char*	p	= s + sizeof( s ) - 1;
+
+	*p	= '\0';
+
+	do {
+		int	d	= n % base;
+
+		*--p	= (d < 10) ? '0' + d : 'A' + d - 10;
+		n		/= base;
+	} while ( n );
+
+	return write( p );
+}
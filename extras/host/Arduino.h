@@ -0,0 +1,67 @@
+/** Arduino core shim for host (Linux) build of GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *	Minimum set of Arduino API used by the library. 
+ *	digitalRead() returns the level given by digitalWrite() (HIGH if not written), 
+ *	so tests can drive a line like INT. Other pin functions do nothing. Time functions use the host clock. 
+ *	Not used in Arduino builds (Arduino IDE doesn't compile files in 'extras')
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_HOST_ARDUINO_H
+#define ARDUINO_GPIO_NXP_ARD_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "Print.h"
+
+#define	HIGH			1
+#define	LOW				0
+#define	INPUT			0
+#define	OUTPUT			1
+#define	INPUT_PULLUP	2
+#define	CHANGE			1
+#define	FALLING			2
+#define	RISING			3
+#define	LSBFIRST		0
+#define	MSBFIRST		1
+
+#define	PROGMEM
+#define	pgm_read_byte( p )	(*(const uint8_t*)(p))
+#define	pgm_read_word( p )	(*(const uint16_t*)(p))
+#define	pgm_read_dword( p )	(*(const uint32_t*)(p))
+
+unsigned long	millis( void );
+unsigned long	micros( void );
+void			delay( unsigned long ms );
+void			delayMicroseconds( unsigned int us );
+void			yield( void );
+
+void			pinMode( int pin, int mode );
+void			digitalWrite( int pin, int value );
+int				digitalRead( int pin );
+int				digitalPinToInterrupt( int pin );
+void			attachInterrupt( int interrupt, void (*isr)( void ), int mode );
+void			noInterrupts( void );
+void			interrupts( void );
+
+/** Serial on stdout */
+class HardwareSerial : public Print {
+public:
+	void			begin( unsigned long baud );
+	int				available( void );
+	int				read( void );
+	virtual size_t	write( uint8_t c );
+	virtual size_t	write( const uint8_t* buffer, size_t size );
+	using Print::write;
+	operator bool() { return true; }
+};
+
+extern HardwareSerial	Serial;
+
+#endif //	ARDUINO_GPIO_NXP_ARD_HOST_ARDUINO_H
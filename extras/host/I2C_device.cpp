@@ -0,0 +1,179 @@
+#include "I2C_device.h"
+
+TwoWire		Wire;
+SPIClass	SPI;
+
+/* ******** I2C_device ******** */
+
+I2C_device::I2C_device( uint8_t i2c_address ) : i2c_addr( i2c_address )
+{
+}
+
+I2C_device::I2C_device( TwoWire&, uint8_t i2c_address ) : i2c_addr( i2c_address )
+{
+}
+
+I2C_device::~I2C_device()
+{
+}
+
+int I2C_device::tx( const uint8_t*, uint16_t, bool )
+{
+	return -1;
+}
+
+int I2C_device::rx( uint8_t*, uint16_t )
+{
+	return -1;
+}
+
+int I2C_device::reg_w( uint8_t, const uint8_t*, uint16_t )
+{
+	return -1;
+}
+
+int I2C_device::reg_w( uint8_t reg_adr, uint8_t data )
+{
+	return reg_w( reg_adr, &data, 1 );
+}
+
+int I2C_device::reg_r( uint8_t, uint8_t*, uint16_t )
+{
+	return -1;
+}
+
+uint8_t I2C_device::reg_r( uint8_t reg_adr )
+{
+	uint8_t	data	= 0;
+
+	reg_r( reg_adr, &data, 1 );
+
+	return data;
+}
+
+void I2C_device::write_r8( uint8_t reg, uint8_t val )
+{
+	reg_w( reg, val );
+}
+
+void I2C_device::write_r16( uint8_t reg, uint16_t val )
+{
+	uint8_t	data[ 2 ]	= { (uint8_t)(val >> 8), (uint8_t)val };
+
+	reg_w( reg, data, 2 );
+}
+
+uint8_t I2C_device::read_r8( uint8_t reg )
+{
+	return reg_r( reg );
+}
+
+uint16_t I2C_device::read_r16( uint8_t reg )
+{
+	uint8_t	data[ 2 ]	= { 0, 0 };
+
+	reg_r( reg, data, 2 );
+
+	return (data[ 0 ] << 8) | data[ 1 ];
+}
+
+void I2C_device::bit_op8( uint8_t reg, uint8_t mask, uint8_t value )
+{
+	write_r8( reg, (read_r8( reg ) & mask) | value );
+}
+
+void I2C_device::bit_op16( uint8_t reg, uint16_t mask, uint16_t value )
+{
+	write_r16( reg, (read_r16( reg ) & mask) | value );
+}
+
+bool I2C_device::ping( void )
+{
+	uint8_t	data;
+
+	return 0 <= reg_r( 0, &data, 1 );
+}
+
+void I2C_device::scan( void )
+{
+}
+
+void I2C_device::txrx( uint8_t*, uint8_t*, int )
+{
+}
+
+/* ******** TwoWire ******** */
+
+void TwoWire::begin( void )
+{
+}
+
+void TwoWire::end( void )
+{
+}
+
+void TwoWire::setClock( uint32_t )
+{
+}
+
+void TwoWire::beginTransmission( uint8_t )
+{
+}
+
+size_t TwoWire::write( uint8_t )
+{
+	return 0;
+}
+
+size_t TwoWire::write( const uint8_t*, size_t )
+{
+	return 0;
+}
+
+uint8_t TwoWire::endTransmission( bool )
+{
+	return 4;	//	other error
+}
+
+uint8_t TwoWire::requestFrom( uint8_t, uint8_t, bool )
+{
+	return 0;
+}
+
+int TwoWire::available( void )
+{
+	return 0;
+}
+
+int TwoWire::read( void )
+{
+	return -1;
+}
+
+/* ******** SPIClass ******** */
+
+void SPIClass::begin( void )
+{
+}
+
+void SPIClass::end( void )
+{
+}
+
+void SPIClass::beginTransaction( SPISettings )
+{
+}
+
+void SPIClass::endTransaction( void )
+{
+}
+
+uint8_t SPIClass::transfer( uint8_t )
+{
+	return 0xFF;
+}
+
+void SPIClass::transfer( void* buf, size_t count )
+{
+	memset( buf, 0xFF, count );
+}
@@ -0,0 +1,52 @@
+/** I2C_device shim for host (Linux) build of GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *	Same interface as I2C_device library. 
+ *	Bus accesses fail (no Wire on host). Register accessors go through virtual reg_w()/reg_r(), 
+ *	so GPIO_base routes them to its transport. 
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_HOST_I2C_DEVICE_H
+#define ARDUINO_GPIO_NXP_ARD_HOST_I2C_DEVICE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+
+class I2C_device {
+public:
+	I2C_device( uint8_t i2c_address );
+	I2C_device( TwoWire& wire, uint8_t i2c_address );
+	virtual ~I2C_device();
+
+	virtual int		tx( const uint8_t* data, uint16_t size, bool stop = true );
+	virtual int		rx( uint8_t* data, uint16_t size );
+
+	virtual int		reg_w( uint8_t reg_adr, const uint8_t* data, uint16_t size );
+	virtual int		reg_w( uint8_t reg_adr, uint8_t data );
+	virtual int		reg_r( uint8_t reg_adr, uint8_t* data, uint16_t size );
+	virtual uint8_t	reg_r( uint8_t reg_adr );
+
+	void			write_r8( uint8_t reg, uint8_t val );
+	void			write_r16( uint8_t reg, uint16_t val );
+	uint8_t			read_r8( uint8_t reg );
+	uint16_t		read_r16( uint8_t reg );
+	void			bit_op8( uint8_t reg, uint8_t mask, uint8_t value );
+	void			bit_op16( uint8_t reg, uint16_t mask, uint16_t value );
+
+	/** Ping by reading register 0 through reg_r() */
+	bool			ping( void );
+
+	static void		scan( void );
+
+protected:
+	uint8_t			i2c_addr;
+	SPISettings		spi_setting;
+
+	void			txrx( uint8_t* w_data, uint8_t* r_data, int size );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_HOST_I2C_DEVICE_H
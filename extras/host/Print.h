@@ -0,0 +1,54 @@
+/** Print class shim for host (Linux) build of GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_HOST_PRINT_H
+#define ARDUINO_GPIO_NXP_ARD_HOST_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define	DEC	10
+#define	HEX	16
+#define	OCT	8
+#define	BIN	2
+
+/** Print class
+ *	
+ *  @class Print
+ *
+ *	Same interface as Arduino Print class for text and binary output
+ */
+class Print {
+public:
+	virtual ~Print() {}
+
+	virtual size_t	write( uint8_t c )	= 0;
+	virtual size_t	write( const uint8_t* buffer, size_t size );
+	size_t			write( const char* str );
+
+	size_t	print( const char* s );
+	size_t	print( char c );
+	size_t	print( int n, int base = DEC );
+	size_t	print( unsigned int n, int base = DEC );
+	size_t	print( long n, int base = DEC );
+	size_t	print( unsigned long n, int base = DEC );
+	size_t	print( double n, int digits = 2 );
+
+	size_t	println( void );
+	size_t	println( const char* s );
+	size_t	println( char c );
+	size_t	println( int n, int base = DEC );
+	size_t	println( unsigned int n, int base = DEC );
+	size_t	println( long n, int base = DEC );
+	size_t	println( unsigned long n, int base = DEC );
+	size_t	println( double n, int digits = 2 );
+
+private:
+	size_t	number( unsigned long n, int base );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_HOST_PRINT_H
@@ -0,0 +1,43 @@
+/** SPI (SPIClass) shim for host (Linux) build of GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *	No SPI bus is available through this class. 
+ *	On host, devices should be given a transport like LINUX_SPI by GPIO_base::transport()
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_HOST_SPI_H
+#define ARDUINO_GPIO_NXP_ARD_HOST_SPI_H
+
+#include <Arduino.h>
+
+#define	SPI_MODE0	0x00
+#define	SPI_MODE1	0x01
+#define	SPI_MODE2	0x02
+#define	SPI_MODE3	0x03
+
+class SPISettings {
+public:
+	SPISettings() : clock( 1000000 ), order( MSBFIRST ), mode( SPI_MODE0 ) {}
+	SPISettings( uint32_t c, uint8_t o, uint8_t m ) : clock( c ), order( o ), mode( m ) {}
+
+	uint32_t	clock;
+	uint8_t		order;
+	uint8_t		mode;
+};
+
+class SPIClass {
+public:
+	void	begin( void );
+	void	end( void );
+	void	beginTransaction( SPISettings settings );
+	void	endTransaction( void );
+	uint8_t	transfer( uint8_t data );
+	void	transfer( void* buf, size_t count );
+};
+
+extern SPIClass	SPI;
+
+#endif //	ARDUINO_GPIO_NXP_ARD_HOST_SPI_H
@@ -0,0 +1,32 @@
+/** Wire (TwoWire) shim for host (Linux) build of GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ *
+ *	No I2C bus is available through this class. 
+ *	On host, devices should be given a transport like LINUX_I2C by GPIO_base::transport()
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_HOST_WIRE_H
+#define ARDUINO_GPIO_NXP_ARD_HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+	void	begin( void );
+	void	end( void );
+	void	setClock( uint32_t clock );
+	void	beginTransmission( uint8_t address );
+	size_t	write( uint8_t data );
+	size_t	write( const uint8_t* data, size_t size );
+	uint8_t	endTransmission( bool stop = true );
+	uint8_t	requestFrom( uint8_t address, uint8_t size, bool stop = true );
+	int		available( void );
+	int		read( void );
+};
+
+extern TwoWire	Wire;
+
+#endif //	ARDUINO_GPIO_NXP_ARD_HOST_WIRE_H
@@ -0,0 +1,26 @@
+/** Minimum test helper for host tests of GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_TEST_H
+#define ARDUINO_GPIO_NXP_ARD_TEST_H
+
+#include <stdio.h>
+
+static int	test_failures	= 0;
+
+/** Check a condition. Failure is reported and counted, test continues */
+#define	CHECK( cond )	do {																	\
+							if ( !(cond) ) {													\
+								printf( "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond );	\
+								test_failures++;												\
+							}																	\
+						} while ( 0 )
+
+/** Result of the test, to be returned from main() */
+#define	TEST_RESULT()	(printf( "%s: %s\n", __FILE__, test_failures ? "FAILED" : "passed" ), test_failures ? 1 : 0)
+
+#endif //	ARDUINO_GPIO_NXP_ARD_TEST_H
@@ -0,0 +1,75 @@
+/*
+ *	Benchmark of BIT_OPS::ports_to_pins()
+ *
+ *	Port snapshots of a PCAL6534 (5 ports) are converted into pin streams by 
+ *	per-bit loop, SWAR kernel (8 time steps per call) and ports_to_pins() which uses SSE2 when available. 
+ *
+ *	Build and run by 'make benchmark'
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "BIT_OPS.h"
+
+static const int	N_PORTS		= 5;
+static const int	N_SAMPLES	= 65536;
+static const int	STRIDE		= N_SAMPLES / 8;
+static const int	REPEAT		= 50;
+
+typedef std::chrono::steady_clock	steady;
+
+static uint8_t	snap[ N_SAMPLES * N_PORTS ];
+static uint8_t	streams[ N_PORTS * 8 * STRIDE ];
+
+static void per_bit( void )
+{
+	memset( streams, 0, sizeof( streams ) );
+
+	for ( int t = 0; t < N_SAMPLES; t++ )
+		for ( int n = 0; n < N_PORTS * 8; n++ )
+			streams[ n * STRIDE + t / 8 ]	|= ((snap[ t * N_PORTS + n / 8 ] >> (n % 8)) & 1) << (t % 8);
+}
+
+static void swar( void )
+{
+	for ( int t = 0; t < N_SAMPLES; t += 8 )
+		BIT_OPS::ports_to_pins( snap + t * N_PORTS, N_PORTS, 8, streams + t / 8, STRIDE );
+}
+
+static void simd( void )
+{
+	BIT_OPS::ports_to_pins( snap, N_PORTS, N_SAMPLES, streams );
+}
+
+static void run( const char* name, void (*func)( void ) )
+{
+	uint32_t			sum	= 0;
+	steady::time_point	t0	= steady::now();
+
+	for ( int i = 0; i < REPEAT; i++ ) {
+		func();
+		sum	+= streams[ i % sizeof( streams ) ];
+	}
+
+	double	sec	= std::chrono::duration<double>( steady::now() - t0 ).count();
+
+	printf( "%-10s: %7.2f ns/sample (%u)\n", name, sec * 1e9 / ((double)N_SAMPLES * REPEAT), sum );
+}
+
+int main( void )
+{
+	for ( int i = 0; i < N_SAMPLES * N_PORTS; i++ )
+		snap[ i ]	= rand();
+
+	printf( "ports_to_pins: %d ports, %d samples\n", N_PORTS, N_SAMPLES );
+	run( "per-bit", per_bit );
+	run( "SWAR", swar );
+#if defined( __SSE2__ )
+	run( "SSE2", simd );
+#endif
+
+	return 0;
+}
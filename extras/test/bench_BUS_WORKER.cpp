@@ -0,0 +1,114 @@
+/*
+ *	Benchmark of BUS_WORKER on SIM_TRANSPORT
+ *
+ *	Application threads write ports through the worker. 
+ *	Throughput, latency percentiles and number of bus transfers are shown 
+ *	and compared with the threads accessing the device directly under a BUS_LOCK. 
+ *
+ *	Build and run by 'make benchmark'
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "PCAL6534.h"
+#include "BUS_WORKER.h"
+#include "SIM_TRANSPORT.h"
+
+static const uint32_t	BUS_CLOCK		= 1000000;	//	Fast-mode Plus
+static const uint32_t	OVERHEAD		= 20;		//	ioctl overhead in microseconds
+static const int		REQUESTS		= 2000;		//	per thread
+
+typedef std::chrono::steady_clock	steady;
+
+static double elapsed_sec( steady::time_point t )
+{
+	return std::chrono::duration<double>( steady::now() - t ).count();
+}
+
+static void direct( int n_threads )
+{
+	SIM_TRANSPORT				bus( BUS_CLOCK, OVERHEAD );
+	BUS_LOCK					lock;
+	PCAL6534					gpio;
+	std::vector<std::thread>	th;
+	steady::time_point			t0	= steady::now();
+
+	gpio.transport( &bus );
+	gpio.bus_lock( &lock );
+
+	for ( int t = 0; t < n_threads; t++ ) {
+		th.push_back( std::thread( [ & ]( int id ) {
+			for ( int i = 0; i < REQUESTS; i++ )
+				gpio.write_port( OUT, (uint8_t)i, id % gpio.n_ports );
+		}, t ) );
+	}
+
+	for ( auto& t : th )
+		t.join();
+
+	double	sec	= elapsed_sec( t0 );
+
+	printf( "direct   %2d threads,   no pace: %9.0f req/s, %6u transfers\n", n_threads, n_threads * REQUESTS / sec, bus.transactions() );
+}
+
+static void worker( int n_threads, uint32_t pace_us )
+{
+	SIM_TRANSPORT				bus( BUS_CLOCK, OVERHEAD );
+	PCAL6534					gpio;
+	BUS_WORKER					w;
+	BUS_WORKER::stats			s;
+	std::vector<std::thread>	th;
+	std::vector<uint8_t>		values( n_threads * REQUESTS );
+
+	gpio.transport( &bus );
+	w.start();
+	w.reset_statistics();
+
+	for ( int t = 0; t < n_threads; t++ ) {
+		th.push_back( std::thread( [ & ]( int id ) {
+			for ( int i = 0; i < REQUESTS; i++ ) {
+				uint8_t*	vp	= &values[ id * REQUESTS + i ];
+
+				*vp	= i;
+
+				while ( !w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, vp, id % gpio.n_ports ) )
+					std::this_thread::yield();
+
+				if ( pace_us )
+					std::this_thread::sleep_for( std::chrono::microseconds( pace_us ) );
+			}
+		}, t ) );
+	}
+
+	for ( auto& t : th )
+		t.join();
+
+	w.flush();
+	w.statistics( &s );
+
+	printf( "worker   %2d threads, %4uus pace: %9.0f req/s, %6llu transfers, latency p50 %6uus p99 %6uus p99.9 %6uus, rejected %llu\n",
+			n_threads, pace_us, w.throughput(), (unsigned long long)s.transfers,
+			w.latency_percentile( 50.0 ), w.latency_percentile( 99.0 ), w.latency_percentile( 99.9 ),
+			(unsigned long long)s.rejected );
+}
+
+int main( void )
+{
+	printf( "SIM_TRANSPORT %luHz, %luus per transaction overhead, %d requests per thread\n",
+			(unsigned long)BUS_CLOCK, (unsigned long)OVERHEAD, REQUESTS );
+
+	//	Saturated: threads submit as fast as possible
+	for ( int n = 1; n <= 8; n *= 2 ) {
+		direct( n );
+		worker( n, 0 );
+	}
+
+	//	Paced: latency below saturation
+	for ( int n = 1; n <= 8; n *= 2 )
+		worker( n, 200 );
+
+	return 0;
+}
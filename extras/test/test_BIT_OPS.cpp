@@ -0,0 +1,116 @@
+/*
+ *	Test of BIT_OPS kernels against per-bit references
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "BIT_OPS.h"
+#include "TEST.h"
+
+static const int	MAX_PORTS	= 5;
+static const int	MAX_SAMPLES	= 70;
+static const int	STRIDE		= (MAX_SAMPLES + 7) / 8;
+
+static void random_bytes( uint8_t* p, int n )
+{
+	for ( int i = 0; i < n; i++ )
+		p[ i ]	= rand();
+}
+
+static void test_interleave( void )
+{
+	for ( int i = 0; i < 1000; i++ ) {
+		uint32_t	v	= ((uint32_t)rand() << 16) ^ rand();
+		uint64_t	x	= BIT_OPS::interleave( v );
+		bool		ok	= true;
+
+		for ( int b = 0; b < 32; b++ )
+			ok	&= (((v >> b) & 1) == ((x >> (2 * b)) & 1)) && !((x >> (2 * b + 1)) & 1);
+
+		CHECK( ok );
+		CHECK( v == BIT_OPS::deinterleave( x ) );
+		CHECK( v == BIT_OPS::deinterleave( x | 0xAAAAAAAAAAAAAAAAULL ) );	//	odd bits are ignored
+	}
+}
+
+static void test_transpose8( void )
+{
+	for ( int i = 0; i < 1000; i++ ) {
+		uint64_t	x	= ((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^ rand();
+		uint64_t	t	= BIT_OPS::transpose8( x );
+		bool		ok	= true;
+
+		for ( int r = 0; r < 8; r++ )
+			for ( int c = 0; c < 8; c++ )
+				ok	&= ((x >> (r * 8 + c)) & 1) == ((t >> (c * 8 + r)) & 1);
+
+		CHECK( ok );
+		CHECK( x == BIT_OPS::transpose8( t ) );
+	}
+}
+
+//	Against per-bit reference, for SIMD path (16 steps) and SWAR tails
+static void test_ports_to_pins( void )
+{
+	uint8_t	snap[ MAX_SAMPLES * MAX_PORTS ];
+	uint8_t	streams[ MAX_PORTS * 8 * STRIDE ];
+	uint8_t	back[ MAX_SAMPLES * MAX_PORTS ];
+
+	for ( int np = 1; np <= MAX_PORTS; np++ ) {
+		for ( int ns = 1; ns <= MAX_SAMPLES; ns++ ) {
+			int		stride	= (ns + 7) / 8;
+			bool	ok		= true;
+
+			random_bytes( snap, ns * np );
+			memset( streams, 0, sizeof( streams ) );
+			BIT_OPS::ports_to_pins( snap, np, ns, streams );
+
+			for ( int t = 0; t < ns; t++ )
+				for ( int n = 0; n < np * 8; n++ )
+					ok	&= ((snap[ t * np + n / 8 ] >> (n % 8)) & 1) == ((streams[ n * stride + t / 8 ] >> (t % 8)) & 1);
+
+			CHECK( ok );
+
+			memset( back, 0, sizeof( back ) );
+			BIT_OPS::pins_to_ports( streams, np, ns, back );
+			CHECK( !memcmp( snap, back, ns * np ) );
+		}
+	}
+}
+
+//	SIMD path gives same streams as SWAR path (steps converted 8 by 8)
+static void test_simd_vs_swar( void )
+{
+	uint8_t	snap[ MAX_SAMPLES * MAX_PORTS ];
+	uint8_t	simd[ MAX_PORTS * 8 * STRIDE ];
+	uint8_t	swar[ MAX_PORTS * 8 * STRIDE ];
+
+	for ( int np = 1; np <= MAX_PORTS; np++ ) {
+		random_bytes( snap, MAX_SAMPLES * np );
+		memset( simd, 0, sizeof( simd ) );
+		memset( swar, 0, sizeof( swar ) );
+
+		BIT_OPS::ports_to_pins( snap, np, MAX_SAMPLES, simd );
+
+		for ( int t = 0; t < MAX_SAMPLES; t += 8 ) {
+			int	n	= (8 < MAX_SAMPLES - t) ? 8 : MAX_SAMPLES - t;
+
+			BIT_OPS::ports_to_pins( snap + t * np, np, n, swar + t / 8, STRIDE );
+		}
+
+		CHECK( !memcmp( simd, swar, np * 8 * STRIDE ) );
+	}
+}
+
+int main( void )
+{
+	srand( 1 );
+
+	test_interleave();
+	test_transpose8();
+	test_ports_to_pins();
+	test_simd_vs_swar();
+
+	return TEST_RESULT();
+}
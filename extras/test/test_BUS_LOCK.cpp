@@ -0,0 +1,134 @@
+/*
+ *	Test of BUS_LOCK and ISR request path with std::thread on SIM_TRANSPORT
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "PCAL6416A.h"
+#include "BUS_MANAGER.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const int	N_THREADS	= 4;
+static const int	N_LOOPS		= 200;
+
+//	Read-modify-write under a guard is not interleaved with other threads
+static void test_guard_rmw( void )
+{
+	SIM_TRANSPORT	bus( 1000000, 0 );
+	BUS_LOCK		lock;
+	PCAL6416A		gpio0( 0x20 );
+	PCAL6416A		gpio1( 0x21 );
+	std::vector<std::thread>	th;
+
+	gpio0.transport( &bus );
+	gpio1.transport( &bus );
+	gpio0.bus_lock( &lock );
+	gpio1.bus_lock( &lock );
+
+	for ( int t = 0; t < N_THREADS; t++ ) {
+		th.push_back( std::thread( [ & ]( int id ) {
+			PCAL6416A&	g	= (id & 1) ? gpio1 : gpio0;
+
+			for ( int i = 0; i < N_LOOPS; i++ ) {
+				BUS_LOCK::guard	lk( g.bus_lock() );
+				g.write_image( OUT, g.read_image( OUT ) + 1 );
+			}
+		}, t ) );
+	}
+
+	for ( auto& t : th )
+		t.join();
+
+	CHECK( N_THREADS / 2 * N_LOOPS == gpio0.read_image( OUT ) );
+	CHECK( N_THREADS / 2 * N_LOOPS == gpio1.read_image( OUT ) );
+}
+
+//	Accesses in a lock-scoped batch are seen as one by other threads
+static void test_batch( void )
+{
+	SIM_TRANSPORT	bus( 1000000, 0 );
+	BUS_LOCK		lock;
+	PCAL6416A		gpio( 0x20 );
+	std::atomic<bool>	done( false );
+	int				torn	= 0;
+
+	gpio.transport( &bus );
+	gpio.bus_lock( &lock );
+
+	std::thread	writer( [ & ]() {
+		for ( int i = 0; i < N_LOOPS; i++ ) {
+			BUS_LOCK::guard	lk( gpio.bus_lock() );
+			gpio.write_port( OUT, (uint8_t)i, 0 );
+			gpio.write_port( OUT, (uint8_t)i, 1 );
+		}
+
+		done	= true;
+	} );
+
+	std::thread	reader( [ & ]() {
+		while ( !done ) {
+			BUS_LOCK::guard	lk( gpio.bus_lock() );
+
+			if ( gpio.read_port( OUT, 0 ) != gpio.read_port( OUT, 1 ) )
+				torn++;
+		}
+	} );
+
+	writer.join();
+	reader.join();
+
+	CHECK( 0 == torn );
+}
+
+static volatile int	n_completed	= 0;
+
+static void completed( BUS_REQUEST* )
+{
+	n_completed	= n_completed + 1;
+}
+
+//	Requests pushed from "ISR" thread through lock-free queue are executed by bus thread
+static void test_isr_path( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	BUS_MANAGER		manager;
+	PCAL6416A		gpio( 0x20 );
+	uint8_t			values[ N_LOOPS ];
+	int				b	= manager.add_bus( Wire );
+
+	gpio.transport( &bus );
+	CHECK( manager.add( gpio, b ) );
+
+	std::thread	isr( [ & ]() {
+		for ( int i = 0; i < N_LOOPS; i++ ) {
+			BUS_REQUEST	req	= { &gpio, BUS_REQUEST::WRITE_SINGLE, OUT, 0, 0, values + i, completed, NULL };
+
+			values[ i ]	= i;
+
+			while ( !manager.submit_from_isr( req ) )
+				std::this_thread::yield();
+		}
+	} );
+
+	while ( n_completed < N_LOOPS )
+		if ( !manager.run_bus( b ) )
+			std::this_thread::yield();
+
+	isr.join();
+
+	CHECK( N_LOOPS == n_completed );
+	CHECK( (uint8_t)(N_LOOPS - 1) == bus.peek( 0x20, PCAL6416A::Output_Port_0 ) );
+	CHECK( (uint32_t)N_LOOPS == bus.transactions() );
+}
+
+int main( void )
+{
+	test_guard_rmw();
+	test_batch();
+	test_isr_path();
+
+	return TEST_RESULT();
+}
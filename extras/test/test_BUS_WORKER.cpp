@@ -0,0 +1,89 @@
+/*
+ *	Test of BUS_WORKER write coalescing on SIM_TRANSPORT
+ *
+ *	Requests are queued before the worker starts, so that coalescing is deterministic
+ */
+
+#include "PCAL6524.h"
+#include "BUS_WORKER.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x44 >> 1;
+
+static uint64_t run( BUS_WORKER& w )
+{
+	BUS_WORKER::stats	s;
+
+	w.start();
+	w.flush();
+	w.statistics( &s );
+	w.stop();
+
+	return s.transfers;
+}
+
+//	Neighboring single writes inside the block are merged
+static void test_merge( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6524		gpio;
+	BUS_WORKER		w;
+	uint8_t			v[ 3 ]	= { 0x10, 0x11, 0x12 };
+
+	gpio.transport( &bus );
+
+	w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, v + 1, 1 );
+	w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, v + 2, 2 );
+	w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, v + 0, 0 );
+
+	CHECK( 1 == run( w ) );
+	CHECK( 0x10 == bus.peek( ADDRESS, PCAL6524::Output_Port_0 ) );
+	CHECK( 0x12 == bus.peek( ADDRESS, PCAL6524::Output_Port_2 ) );
+}
+
+//	Single write just past the block is not merged into the block burst
+static void test_block_boundary( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6524		gpio;
+	BUS_WORKER		w;
+	uint8_t			all[ 3 ]	= { 0x21, 0x22, 0x23 };
+	uint8_t			past		= 0x5A;
+	uint8_t			last		= 0x33;
+
+	gpio.transport( &bus );
+
+	w.submit( gpio, BUS_REQUEST::WRITE_PORT, OUT, all );
+	w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, &past, 3 );
+	w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, &last, 2 );
+
+	CHECK( 3 == run( w ) );
+	CHECK( 0x21 == bus.peek( ADDRESS, PCAL6524::Output_Port_0 ) );
+	CHECK( 0x33 == bus.peek( ADDRESS, PCAL6524::Output_Port_2 ) );
+}
+
+//	Ports far out of the block are issued one by one without the coalescing image
+static void test_out_of_block( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6524		gpio;
+	BUS_WORKER		w;
+	uint8_t			v[ 2 ]	= { 1, 2 };
+
+	gpio.transport( &bus );
+
+	w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, v + 0, 20 );
+	w.submit( gpio, BUS_REQUEST::WRITE_SINGLE, OUT, v + 1, 21 );
+
+	CHECK( 2 == run( w ) );
+}
+
+int main( void )
+{
+	test_merge();
+	test_block_boundary();
+	test_out_of_block();
+
+	return TEST_RESULT();
+}
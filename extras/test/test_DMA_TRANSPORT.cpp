@@ -0,0 +1,180 @@
+/*
+ *	Test of DMA_TRANSPORT with SIM_DMA engine on SIM_TRANSPORT
+ */
+
+#include "PCAL6534.h"
+#include "DMA_TRANSPORT.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x44 >> 1;
+
+/* Transport which fails given number of writes */
+class FAULTY : public GPIO_TRANSPORT {
+public:
+	FAULTY( GPIO_TRANSPORT& bus ) : tp( bus ), faults( 0 ) {}
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+	{
+		if ( faults ) {
+			faults--;
+			return -1;
+		}
+
+		return tp.reg_w( address, reg, data, size );
+	}
+
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+	{
+		return tp.reg_r( address, reg, data, size );
+	}
+
+	GPIO_TRANSPORT&	tp;
+	int				faults;
+};
+
+static int	n_callbacks	= 0;
+
+static void done( void*, int result )
+{
+	if ( 0 <= result )
+		n_callbacks++;
+}
+
+//	Bursts go to DMA, single register accesses to polled transport
+static void test_threshold( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	SIM_DMA			engine( bus );
+	DMA_TRANSPORT	dt( engine, &bus, 4 );
+	PCAL6534		gpio( ADDRESS );
+	uint8_t			out[ 5 ]	= { 1, 2, 3, 4, 5 };
+	uint8_t			in[ 5 ];
+
+	dt.callback( done );
+	gpio.transport( &dt );
+
+	gpio.write_port( OUT, out );			//	5 byte burst by DMA, without waiting
+	gpio.write_port( OUT, (uint8_t)9, 1 );	//	single register by polled transport
+	gpio.read_port( OUT, in );				//	5 byte burst by DMA
+
+	CHECK( 2 == (int)dt.dma_count() );
+	CHECK( 2 == (int)engine.transfers() );
+	CHECK( 2 == n_callbacks );
+	CHECK( (1 == in[ 0 ]) && (9 == in[ 1 ]) && (5 == in[ 4 ]) );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+}
+
+//	Without polled transport, small accesses are left to the device's default path
+static void test_default_path( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	SIM_DMA			engine( bus );
+	DMA_TRANSPORT	dt( engine, NULL, 4 );
+	PCAL6534		gpio( ADDRESS );
+
+	gpio.transport( &dt );
+
+	CHECK( GPIO_TRANSPORT::NOT_HANDLED == dt.reg_w( ADDRESS, 0x05, (const uint8_t*)"\x55", 1 ) );
+
+	//	Host shim has no Wire bus, so the default path fails. DMA is not used
+	gpio.write_port( OUT, (uint8_t)0x55, 0 );
+	CHECK( 0 == (int)dt.dma_count() );
+	CHECK( 0x00 == bus.peek( ADDRESS, PCAL6534::Output_Port_0 ) );
+	CHECK( GPIO_base::XFER_ERROR == gpio.last_status() );
+}
+
+//	Failure of a write without waiting is reported by next access and covered by its retry
+static void test_deferred_failure( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	FAULTY			faulty( bus );
+	SIM_DMA			engine( faulty );
+	DMA_TRANSPORT	dt( engine, &bus, 4 );
+	PCAL6534		gpio( ADDRESS );
+	uint8_t			out[ 5 ]	= { 1, 2, 3, 4, 5 };
+
+	gpio.transport( &dt );
+
+	//	No retry: next access reports the error
+	faulty.faults	= 2;
+	gpio.write_port( OUT, out );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );		//	not completed yet
+	gpio.read_port( IN, 0 );
+	CHECK( GPIO_base::XFER_ERROR == gpio.last_status() );	//	failed, and failed again
+
+	//	With retry: the write is done again and the access succeeds
+	gpio.retry_policy( 2, 1 );
+	CHECK( 0x01 == gpio.read_port( OUT, 0 ) );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+	CHECK( 0x05 == bus.peek( ADDRESS, PCAL6534::Output_Port_4 ) );
+
+	//	Failed, failed again at next access, and done by its retry
+	faulty.faults	= 2;
+	out[ 4 ]		= 0x50;
+	gpio.write_port( OUT, out );
+	CHECK( 0x50 == gpio.read_port( OUT, 4 ) );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+	CHECK( 1 == gpio.last_retries() );
+}
+
+//	Failure of a write without waiting is reported to its own device only
+static void test_two_devices( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	FAULTY			faulty( bus );
+	SIM_DMA			engine( faulty );
+	DMA_TRANSPORT	dt( engine, &bus, 4 );
+	PCAL6534		gpio_a( ADDRESS );
+	PCAL6534		gpio_b( ADDRESS + 1 );
+	uint8_t			out_a[ 5 ]	= { 1, 2, 3, 4, 5 };
+	uint8_t			out_b[ 5 ]	= { 6, 7, 8, 9, 10 };
+
+	gpio_a.transport( &dt );
+	gpio_b.transport( &dt );
+
+	//	Other device is not affected. Its burst waits while the failed write is kept
+	faulty.faults	= 1;
+	gpio_a.write_port( OUT, out_a );
+	gpio_b.read_port( IN, 0 );
+	CHECK( GPIO_base::XFER_OK == gpio_b.last_status() );
+	gpio_b.write_port( OUT, out_b );
+	CHECK( GPIO_base::XFER_OK == gpio_b.last_status() );
+	CHECK( 10 == bus.peek( ADDRESS + 1, PCAL6534::Output_Port_4 ) );
+	CHECK( 0 == bus.peek( ADDRESS, PCAL6534::Output_Port_4 ) );
+
+	//	Next access to the device does the write again
+	gpio_a.read_port( IN, 0 );
+	CHECK( GPIO_base::XFER_OK == gpio_a.last_status() );
+	CHECK( 5 == bus.peek( ADDRESS, PCAL6534::Output_Port_4 ) );
+
+	//	Failed again at next access to the device
+	faulty.faults	= 2;
+	out_a[ 4 ]		= 0x50;
+	gpio_a.write_port( OUT, out_a );
+	gpio_b.read_port( IN, 0 );
+	CHECK( GPIO_base::XFER_OK == gpio_b.last_status() );
+	gpio_a.read_port( IN, 0 );
+	CHECK( GPIO_base::XFER_ERROR == gpio_a.last_status() );
+	CHECK( 0 == dt.sync() );
+	CHECK( 0x50 == bus.peek( ADDRESS, PCAL6534::Output_Port_4 ) );
+
+	//	Reported by sync()
+	faulty.faults	= 2;
+	out_a[ 4 ]		= 0x51;
+	gpio_a.write_port( OUT, out_a );
+	CHECK( 0 > dt.sync() );
+	CHECK( 0 == dt.sync() );
+	CHECK( 0x51 == bus.peek( ADDRESS, PCAL6534::Output_Port_4 ) );
+	CHECK( 0 == dt.sync() );
+}
+
+int main( void )
+{
+	test_threshold();
+	test_default_path();
+	test_deferred_failure();
+	test_two_devices();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,140 @@
+/*
+ *	Test of GPIO_SPI pipelined mode on SIM_TRANSPORT
+ */
+
+#include "PCAL9722.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x40 >> 1;
+
+static void test_single_read( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL9722		gpio;
+
+	gpio.transport( &bus );
+	bus.poke( ADDRESS, PCAL9722::Input_Port_1, 0x5A );
+	bus.poke( ADDRESS, PCAL9722::Configuration_port_2, 0xF0 );
+
+	gpio.begin_pipeline();
+	gpio.output( 0, 0x12 );
+	CHECK( 0x5A == gpio.input( 1 ) );					//	value is available on return
+	CHECK( 2 == (int)bus.transactions() );				//	queued write is issued with the read
+	gpio.config( 2, 0x03, 0xF0 );						//	read-modify-write
+	gpio.output( 1, 0x34 );
+	CHECK( 0x5A == gpio.read_port( IN, 1 ) );
+	gpio.end_pipeline();
+
+	CHECK( 0x12 == bus.peek( ADDRESS, PCAL9722::Output_Port_0 ) );
+	CHECK( 0x34 == bus.peek( ADDRESS, PCAL9722::Output_Port_1 ) );
+	CHECK( 0x03 == bus.peek( ADDRESS, PCAL9722::Configuration_port_2 ) );
+}
+
+static void test_write_read_port( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL9722		gpio;
+	uint8_t			out[ 3 ]	= { 0x11, 0x22, 0x33 };
+	uint8_t			in[ 3 ]		= { 0, 0, 0 };
+
+	gpio.transport( &bus );
+	bus.poke( ADDRESS, PCAL9722::Input_Port_0, 0xA1 );
+	bus.poke( ADDRESS, PCAL9722::Input_Port_2, 0xA3 );
+
+	gpio.write_read_port( OUT, out, IN, in );
+
+	CHECK( 0x33 == bus.peek( ADDRESS, PCAL9722::Output_Port_2 ) );
+	CHECK( (0xA1 == in[ 0 ]) && (0xA3 == in[ 2 ]) );
+	CHECK( 2 == (int)bus.transactions() );
+}
+
+//	Multi-byte reads used on return are valid inside a pipeline
+static void test_read_in_pipeline( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL9722		gpio;
+	uint8_t			in[ 3 ]		= { 0, 0, 0 };
+
+	gpio.transport( &bus );
+	bus.poke( ADDRESS, PCAL9722::Input_Port_0, 0xA5 );
+	bus.poke( ADDRESS, PCAL9722::Input_Port_1, 0x5A );
+	bus.poke( ADDRESS, PCAL9722::Output_drive_strength_register_port_0A, 0xF0 );
+
+	gpio.begin_pipeline();
+	gpio.output( 2, 0x77 );
+	CHECK( 0x5AA5 == gpio.read_image( IN ) );
+	gpio.write_pin2( DRIVE_STRENGTH, 0x0003, 1 );		//	read-modify-write on a local buffer
+	gpio.read_port_deferred( IN, in );
+	CHECK( 0 == in[ 0 ] );								//	deferred read is filled at end_pipeline()
+	gpio.end_pipeline();
+
+	CHECK( (0xA5 == in[ 0 ]) && (0x5A == in[ 1 ]) );
+	CHECK( 0x77 == bus.peek( ADDRESS, PCAL9722::Output_Port_2 ) );
+	CHECK( 0xF5 == bus.peek( ADDRESS, PCAL9722::Output_drive_strength_register_port_0A ) );
+}
+
+/* Transport which fails given number of frames */
+class FAULTY : public GPIO_TRANSPORT {
+public:
+	FAULTY( GPIO_TRANSPORT& bus ) : tp( bus ), faults( 0 ) {}
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+	{
+		return tp.reg_w( address, reg, data, size );
+	}
+
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+	{
+		return tp.reg_r( address, reg, data, size );
+	}
+
+	virtual int	txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+	{
+		if ( faults ) {
+			faults--;
+			return -1;
+		}
+
+		return tp.txrx( w_data, r_data, size );
+	}
+
+	GPIO_TRANSPORT&	tp;
+	int				faults;
+};
+
+//	SPI frames go through retries and report status
+static void test_status( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	FAULTY			ft( bus );
+	PCAL9722		gpio;
+
+	gpio.transport( &ft );
+	gpio.retry_policy( 1, 100 );
+
+	ft.faults	= 1;
+	gpio.output( 0, 0x42 );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+	CHECK( 1 == gpio.last_retries() );
+	CHECK( 0x42 == bus.peek( ADDRESS, PCAL9722::Output_Port_0 ) );
+
+	ft.faults	= 2;
+	gpio.input( 0 );
+	CHECK( GPIO_base::XFER_ERROR == gpio.last_status() );
+	CHECK( 0 < gpio.last_elapsed() );
+
+	gpio.input( 0 );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+	CHECK( 0 == gpio.last_retries() );
+}
+
+int main( void )
+{
+	test_single_read();
+	test_write_read_port();
+	test_read_in_pipeline();
+	test_status();
+
+	return TEST_RESULT();
+}
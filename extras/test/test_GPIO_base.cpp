@@ -0,0 +1,83 @@
+/*
+ *	Test of GPIO_base transfer status on SIM_TRANSPORT
+ */
+
+#include "PCAL6416A.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x20;
+
+/* Transport which fails given number of reads */
+class FAULTY : public GPIO_TRANSPORT {
+public:
+	FAULTY( GPIO_TRANSPORT& bus ) : tp( bus ), faults( 0 ) {}
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+	{
+		return tp.reg_w( address, reg, data, size );
+	}
+
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+	{
+		if ( faults ) {
+			faults--;
+			return -1;
+		}
+
+		return tp.reg_r( address, reg, data, size );
+	}
+
+	GPIO_TRANSPORT&	tp;
+	int				faults;
+};
+
+//	Failed read in bit_op8() is not hidden by following successful write
+static void test_bit_op( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	FAULTY			ft( bus );
+	PCAL6416A		gpio( ADDRESS );
+
+	gpio.transport( &ft );
+
+	ft.faults	= 1;
+	gpio.bit_op8( PCAL6416A::Output_Port_0, 0x0F, 0x50 );
+	CHECK( GPIO_base::XFER_ERROR == gpio.last_status() );
+
+	gpio.bit_op8( PCAL6416A::Output_Port_0, 0x0F, 0x50 );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+}
+
+//	Status covers all transactions of write_pin2()
+static void test_write_pin2( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	FAULTY			ft( bus );
+	PCAL6416A		gpio( ADDRESS );
+
+	gpio.transport( &ft );
+	gpio.retry_policy( 1, 1 );
+
+	ft.faults	= 1;
+	gpio.drive_strength( 0x0003, 2 );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+	CHECK( 1 == gpio.last_retries() );
+
+	ft.faults	= 2;
+	gpio.drive_strength( 0x0003, 1 );
+	CHECK( GPIO_base::XFER_ERROR == gpio.last_status() );
+
+	gpio.drive_strength( 0x0003, 1 );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+	CHECK( 0 == gpio.last_retries() );
+	CHECK( 0x05 == (bus.peek( ADDRESS, PCAL6416A::Output_drive_strength_register_0 ) & 0x0F) );
+}
+
+int main( void )
+{
+	test_bit_op();
+	test_write_pin2();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+/*
+ *	Test of 16 bit port accesses on SIM_TRANSPORT
+ */
+
+#include "PCAL6524.h"
+#include "PCAL9722.h"
+#include "PCA9555.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS		= 0x44 >> 1;
+static const uint8_t	SPI_ADDRESS	= 0x40 >> 1;
+
+//	Port numbers out of the block make no access
+static void test_out_of_range( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6524		gpio;
+
+	gpio.transport( &bus );
+	bus.poke( ADDRESS, PCAL6524::Input_Port_0, 0x11 );
+	bus.poke( ADDRESS, PCAL6524::Input_Port_1, 0x22 );
+	bus.poke( ADDRESS, PCAL6524::Input_Port_2, 0x33 );
+	bus.poke( ADDRESS, PCAL6524::reserved0, 0x44 );
+
+	CHECK( 0 == gpio.read_port16( IN, 4 ) );
+	CHECK( 0 == gpio.read_port16( IN, 3 ) );
+	CHECK( 0 == gpio.read_port16( IN, -1 ) );
+	CHECK( 0 == gpio.read_pair16( IN, 2 ) );
+	CHECK( 0 == (int)bus.transactions() );
+
+	gpio.write_port16( OUT, 0xABCD, 3 );
+	gpio.write_port16( OUT, 0xABCD, 100 );
+	gpio.write_pair16( OUT, 0xABCD, 2 );
+	CHECK( 0 == (int)bus.transactions() );
+	CHECK( 0 == bus.peek( ADDRESS, PCAL6524::reserved1 ) );
+}
+
+//	Odd port numbers and the last port of the block
+static void test_odd_port( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6524		gpio;
+
+	gpio.transport( &bus );
+	bus.poke( ADDRESS, PCAL6524::Input_Port_0, 0x11 );
+	bus.poke( ADDRESS, PCAL6524::Input_Port_1, 0x22 );
+	bus.poke( ADDRESS, PCAL6524::Input_Port_2, 0x33 );
+	bus.poke( ADDRESS, PCAL6524::reserved0, 0x44 );
+
+	CHECK( 0x2233 == gpio.read_port16( IN, 1 ) );
+	CHECK( 0x3300 == gpio.read_port16( IN, 2 ) );
+	CHECK( 0x1122 == gpio.read_pair16( IN, 0 ) );
+
+	gpio.write_port16( OUT, 0xABCD, 1 );
+	CHECK( 0xAB == bus.peek( ADDRESS, PCAL6524::Output_Port_1 ) );
+	CHECK( 0xCD == bus.peek( ADDRESS, PCAL6524::Output_Port_2 ) );
+
+	gpio.write_port16( OUT, 0x5AA5, 2 );
+	CHECK( 0x5A == bus.peek( ADDRESS, PCAL6524::Output_Port_2 ) );
+	CHECK( 0x00 == bus.peek( ADDRESS, PCAL6524::reserved1 ) );
+}
+
+//	Array write: register 'A' is upper byte, on I2C and SPI
+static void test_array( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6524		gpio;
+	PCAL9722		spi_gpio;
+	const uint16_t	v[ 3 ]	= { 0x0102, 0x0304, 0x0506 };
+	uint16_t		r[ 3 ];
+
+	gpio.transport( &bus );
+	spi_gpio.transport( &bus );
+
+	gpio.write_port16( DRIVE_STRENGTH, v );
+	spi_gpio.write_port16( DRIVE_STRENGTH, v );
+
+	for ( int i = 0; i < 6; i++ ) {
+		CHECK( i + 1 == bus.peek( ADDRESS, PCAL6524::Output_drive_strength_register_port_0A + i ) );
+		CHECK( i + 1 == bus.peek( SPI_ADDRESS, PCAL9722::Output_drive_strength_register_port_0A + i ) );
+	}
+
+	gpio.read_port16( DRIVE_STRENGTH, r );
+	CHECK( (0x0102 == r[ 0 ]) && (0x0506 == r[ 2 ]) );
+}
+
+//	Array write on a device without auto-increment
+static void test_array_non_ai( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCA9555			gpio;
+	const uint16_t	v	= 0xABCD;
+
+	gpio.transport( &bus );
+	gpio.write_port16( OUT, &v );
+
+	CHECK( 0xAB == bus.peek( 0x20, PCA9555::Output_Port_0 ) );
+	CHECK( 0xCD == bus.peek( 0x20, PCA9555::Output_Port_1 ) );
+}
+
+int main( void )
+{
+	test_out_of_range();
+	test_odd_port();
+	test_array();
+	test_array_non_ai();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,65 @@
+/*
+ *	Test of INT_GOVERNOR masking on SIM_TRANSPORT
+ *
+ *	Uses real time of the host. Margins are 20ms or more
+ */
+
+#include "PCAL6416A.h"
+#include "INT_GOVERNOR.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x20;
+
+static void fire( SIM_TRANSPORT& bus, INT_GOVERNOR& gov, uint8_t pins )
+{
+	bus.poke( ADDRESS, PCAL6416A::Interrupt_status_register_0, pins );
+	gov.interrupt();
+	gov.service();
+	bus.poke( ADDRESS, PCAL6416A::Interrupt_status_register_0, 0 );
+}
+
+static void run_until( INT_GOVERNOR& gov, uint32_t start, uint32_t t )
+{
+	while ( micros() - start < t ) {
+		gov.service();
+		delay( 1 );
+	}
+}
+
+//	Pin masked late in a quiet period waits a full period before unmasking
+static void test_quiet_per_pin( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6416A		gpio( ADDRESS );
+	INT_GOVERNOR	gov( gpio, 1, 1000, 100000, 0 );
+	uint32_t		start;
+
+	gpio.transport( &bus );
+	gov.begin( 0x0003 );
+	start	= micros();
+
+	fire( bus, gov, 0x01 );
+	CHECK( 0x01 == gov.masked() );
+
+	run_until( gov, start, 80000 );
+	fire( bus, gov, 0x02 );
+	CHECK( 0x03 == gov.masked() );
+
+	run_until( gov, start, 120000 );
+	CHECK( 0x02 == gov.masked() );
+
+	run_until( gov, start, 170000 );
+	CHECK( 0x02 == gov.masked() );
+
+	run_until( gov, start, 230000 );
+	CHECK( 0x00 == gov.masked() );
+	CHECK( 0x00 == (bus.peek( ADDRESS, PCAL6416A::Interrupt_mask_register_0 ) & 0x03) );
+}
+
+int main( void )
+{
+	test_quiet_per_pin();
+
+	return TEST_RESULT();
+}
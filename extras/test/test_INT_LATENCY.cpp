@@ -0,0 +1,56 @@
+/*
+ *	Test of INT_LATENCY registration
+ *
+ *	Library objects are built without GPIO_NXP_INT_LATENCY, so the instrumented source is built here
+ */
+
+#define	GPIO_NXP_INT_LATENCY
+#include "../../src/INT_LATENCY.cpp"
+#include "PCAL6416A.h"
+#include "TEST.h"
+
+static void measure( GPIO_base* dev )
+{
+	INT_LATENCY_ISR();
+	INT_LATENCY_READ_START( dev );
+	INT_LATENCY_READ_END( dev );
+	INT_LATENCY_DISPATCH( dev );
+}
+
+//	All devices of an INT_RESOLVER can be registered
+static void test_capacity( void )
+{
+	PCAL6416A	gpio[ INT_RESOLVER::MAX_DEVICES + 1 ]	= {
+		PCAL6416A( 0x20 ), PCAL6416A( 0x20 ), PCAL6416A( 0x20 ), PCAL6416A( 0x20 ), PCAL6416A( 0x20 ),
+		PCAL6416A( 0x20 ), PCAL6416A( 0x20 ), PCAL6416A( 0x20 ), PCAL6416A( 0x20 ),
+	};
+
+	for ( int i = 0; i < INT_RESOLVER::MAX_DEVICES; i++ )
+		CHECK( INT_LATENCY::add( gpio + i ) );
+
+	CHECK( INT_LATENCY::add( gpio ) );
+	CHECK( !INT_LATENCY::add( gpio + INT_RESOLVER::MAX_DEVICES ) );
+
+	//	Time stamps of unregistered device don't make a record
+	measure( gpio + INT_RESOLVER::MAX_DEVICES );
+	CHECK( NULL == INT_LATENCY::histogram( gpio + INT_RESOLVER::MAX_DEVICES, INT_LATENCY::TOTAL ) );
+
+	measure( gpio + INT_RESOLVER::MAX_DEVICES - 1 );
+
+	const uint16_t*	h		= INT_LATENCY::histogram( gpio + INT_RESOLVER::MAX_DEVICES - 1, INT_LATENCY::TOTAL );
+	int				total	= 0;
+
+	CHECK( NULL != h );
+
+	for ( int b = 0; h && (b < INT_LATENCY::BINS); b++ )
+		total	+= h[ b ];
+
+	CHECK( 1 == total );
+}
+
+int main( void )
+{
+	test_capacity();
+
+	return TEST_RESULT();
+}
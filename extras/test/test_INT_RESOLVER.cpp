@@ -0,0 +1,93 @@
+/*
+ *	Test of INT_RESOLVER polling order, masking and INT line on SIM_TRANSPORT
+ */
+
+#include "PCAL6534.h"
+#include "INT_RESOLVER.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x44 >> 1;
+static const int		INT_PIN	= 7;
+
+static GPIO_base*	order[ 8 ];
+static int			n_called	= 0;
+static GPIO_base*	release_by	= NULL;
+
+static void callback( GPIO_base& gpio, uint64_t, uint64_t )
+{
+	order[ n_called++ ]	= &gpio;
+
+	//	INT line is deasserted when the device has been serviced
+	if ( &gpio == release_by )
+		digitalWrite( INT_PIN, HIGH );
+}
+
+static void assert_all( SIM_TRANSPORT& bus )
+{
+	for ( int i = 0; i < 3; i++ )
+		bus.poke( ADDRESS + i, PCAL6534::Interrupt_status_register_port_0, 0x01 );
+
+	n_called	= 0;
+	digitalWrite( INT_PIN, LOW );
+}
+
+static void test_resolver( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		low( ADDRESS );
+	PCAL6534		high( ADDRESS + 1 );
+	PCAL6534		mid( ADDRESS + 2 );
+	INT_RESOLVER	resolver( INT_PIN );
+
+	for ( int i = 0; i < 3; i++ ) {
+		bus.poke( ADDRESS + i, PCAL6534::Configuration_port_0, 0xFF );
+		bus.poke( ADDRESS + i, PCAL6534::Interrupt_mask_register_port_0, 0xFE );
+	}
+
+	low.transport( &bus );
+	high.transport( &bus );
+	mid.transport( &bus );
+
+	resolver.add( low, 1, callback );
+	resolver.add( high, 5, callback );
+	resolver.add( mid, 3, callback );
+	resolver.begin();
+
+	//	Polled in priority order
+	assert_all( bus );
+	CHECK( 3 == resolver.service() );
+	CHECK( 3 == resolver.polls() );
+	CHECK( 3 == n_called );
+	CHECK( (&high == order[ 0 ]) && (&mid == order[ 1 ]) && (&low == order[ 2 ]) );
+	CHECK( 0x01 == resolver.status( mid ) );
+
+	//	Masked device is not polled
+	CHECK( resolver.mask( mid, 0x01, true ) );
+	CHECK( 0xFF == bus.peek( ADDRESS + 2, PCAL6534::Interrupt_mask_register_port_0 ) );
+	assert_all( bus );
+	CHECK( 2 == resolver.service() );
+	CHECK( 2 == resolver.polls() );
+	CHECK( (&high == order[ 0 ]) && (&low == order[ 1 ]) );
+
+	//	Polling stops when INT line goes HIGH
+	CHECK( resolver.mask( mid, 0x01, false ) );
+	release_by	= &high;
+	assert_all( bus );
+	CHECK( 1 == resolver.service() );
+	CHECK( 1 == resolver.polls() );
+	CHECK( (1 == n_called) && (&high == order[ 0 ]) );
+
+	//	Nothing is polled while the line is HIGH
+	CHECK( 0 == resolver.service() );
+	CHECK( 0 == resolver.polls() );
+
+	release_by	= NULL;
+}
+
+int main( void )
+{
+	test_resolver();
+
+	return TEST_RESULT();
+}
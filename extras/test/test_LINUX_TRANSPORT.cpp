@@ -0,0 +1,235 @@
+/*
+ *	Test of LINUX_I2C and LINUX_SPI message layout and batching, on stub file descriptor.
+ *	transfer() is overridden to record messages and to emulate devices
+ */
+
+#include "LINUX_TRANSPORT.h"
+#include "PCAL6416A.h"
+#include "PCAL9722.h"
+#include "TEST.h"
+
+class STUB_I2C : public LINUX_I2C {
+public:
+	STUB_I2C() : LINUX_I2C( -1 ), n_calls( 0 ), n_last( 0 ), fail( false ), pointer( 0 ) { memset( regs, 0, sizeof( regs ) ); }
+
+	int				n_calls;
+	int				n_last;
+	struct i2c_msg	last[ MAX_MESSAGES ];
+	uint8_t			regs[ 256 ];
+	bool			fail;
+
+protected:
+	virtual int	transfer( struct i2c_msg* msgs, int n )
+	{
+		n_calls++;
+
+		if ( fail )
+			return -1;
+
+		n_last	= n;
+		memcpy( last, msgs, sizeof( msgs[ 0 ] ) * n );
+
+		for ( int i = 0; i < n; i++ ) {
+			if ( msgs[ i ].flags & I2C_M_RD ) {
+				for ( int k = 0; k < msgs[ i ].len; k++ )
+					msgs[ i ].buf[ k ]	= regs[ (pointer + k) & 0xFF ];
+			}
+			else {
+				pointer	= msgs[ i ].buf[ 0 ] & 0x7F;
+
+				for ( int k = 1; k < msgs[ i ].len; k++ )
+					regs[ (pointer + k - 1) & 0xFF ]	= msgs[ i ].buf[ k ];
+			}
+		}
+
+		return n;
+	}
+
+private:
+	uint8_t	pointer;
+};
+
+class STUB_SPI : public LINUX_SPI {
+public:
+	STUB_SPI() : LINUX_SPI( -1 ), n_calls( 0 ), n_last( 0 ), fail( false ) { memset( regs, 0, sizeof( regs ) ); }
+
+	int				n_calls;
+	int				n_last;
+	uint8_t			regs[ 256 ];
+	bool			fail;
+
+protected:
+	virtual int	transfer( struct spi_ioc_transfer* xfer, int n )
+	{
+		n_calls++;
+
+		if ( fail )
+			return -1;
+
+		n_last	= n;
+
+		for ( int i = 0; i < n; i++ ) {
+			const uint8_t*	w	= (const uint8_t*)(uintptr_t)xfer[ i ].tx_buf;
+			uint8_t*		r	= (uint8_t*)(uintptr_t)xfer[ i ].rx_buf;
+			uint8_t			reg	= w[ 1 ] & 0x7F;
+
+			for ( unsigned int k = 2; k < xfer[ i ].len; k++ ) {
+				if ( !(w[ 0 ] & 0x01) )
+					regs[ (reg + k - 2) & 0xFF ]	= w[ k ];
+				else if ( r )
+					r[ k ]	= regs[ (reg + k - 2) & 0xFF ];
+			}
+		}
+
+		return n;
+	}
+};
+
+static void test_i2c_layout( void )
+{
+	STUB_I2C	bus;
+	uint8_t		w[ 3 ]	= { 0x11, 0x22, 0x33 };
+	uint8_t		r[ 3 ]	= { 0, 0, 0 };
+
+	//	Write: one message of register address + data
+	CHECK( 3 == bus.reg_w( 0x20, 0x84, w, 3 ) );
+	CHECK( 1 == bus.n_calls );
+	CHECK( 1 == bus.n_last );
+	CHECK( 0x20 == bus.last[ 0 ].addr );
+	CHECK( 0 == bus.last[ 0 ].flags );
+	CHECK( 4 == bus.last[ 0 ].len );
+	CHECK( 0x84 == bus.last[ 0 ].buf[ 0 ] );
+	CHECK( !memcmp( bus.last[ 0 ].buf + 1, w, 3 ) );
+
+	//	Read: write of register address and read in one ioctl (repeated-START)
+	CHECK( 3 == bus.reg_r( 0x20, 0x84, r, 3 ) );
+	CHECK( 2 == bus.n_calls );
+	CHECK( 2 == bus.n_last );
+	CHECK( (0x20 == bus.last[ 0 ].addr) && (0 == bus.last[ 0 ].flags) && (1 == bus.last[ 0 ].len) );
+	CHECK( 0x84 == bus.last[ 0 ].buf[ 0 ] );
+	CHECK( (0x20 == bus.last[ 1 ].addr) && (I2C_M_RD == bus.last[ 1 ].flags) && (3 == bus.last[ 1 ].len) );
+	CHECK( r == bus.last[ 1 ].buf );
+	CHECK( !memcmp( r, w, 3 ) );
+}
+
+static void test_i2c_batch( void )
+{
+	STUB_I2C	bus;
+	uint8_t		r[ 4 ];
+
+	bus.begin_batch();
+
+	for ( int i = 0; i < 4; i++ ) {
+		uint8_t	v	= 0x10 + i;
+		bus.reg_w( 0x20, 0x10 + i, &v, 1 );
+	}
+
+	CHECK( 0 == bus.n_calls );	//	writes are queued
+
+	//	Read is issued with queued writes, and data is available on return
+	CHECK( 4 == bus.reg_r( 0x20, 0x90, r, 4 ) );
+	CHECK( 1 == bus.n_calls );
+	CHECK( 6 == bus.n_last );
+	CHECK( (0x10 == r[ 0 ]) && (0x13 == r[ 3 ]) );
+
+	uint8_t	v	= 0x55;
+	bus.reg_w( 0x20, 0x20, &v, 1 );
+	CHECK( 1 == bus.end_batch() );
+	CHECK( 2 == bus.n_calls );
+	CHECK( 0x55 == bus.regs[ 0x20 ] );
+}
+
+static void test_i2c_device( void )
+{
+	STUB_I2C	bus;
+	PCAL6416A	gpio;
+
+	gpio.transport( &bus );
+
+	//	Read-modify-write in a batch uses register value, not uninitialized data
+	bus.regs[ PCAL6416A::Output_Port_0 ]						= 0xF0;
+	bus.regs[ PCAL6416A::Output_drive_strength_register_0 ]	= 0xFF;
+	bus.regs[ PCAL6416A::Output_drive_strength_register_0B ]	= 0xFF;
+
+	bus.begin_batch();
+	gpio.write_port( CONFIG, (uint8_t)0x00, 1 );
+	gpio.bit_op8( PCAL6416A::Output_Port_0, 0xF0, 0x05 );
+	gpio.drive_strength( 0x0002, 1 );
+	bus.end_batch();
+
+	CHECK( 0xF5 == bus.regs[ PCAL6416A::Output_Port_0 ] );
+	CHECK( 0x00 == bus.regs[ PCAL6416A::Configuration_port_1 ] );
+	CHECK( 0xF7 == bus.regs[ PCAL6416A::Output_drive_strength_register_0 ] );
+
+	bus.regs[ PCAL6416A::Input_Port_1 ]	= 0xA5;
+	CHECK( 0xA5 == gpio.input( 1 ) );
+	CHECK( GPIO_base::XFER_OK == gpio.last_status() );
+}
+
+static void test_spi( void )
+{
+	STUB_SPI	bus;
+	PCAL9722	gpio;
+
+	gpio.transport( &bus );
+
+	bus.regs[ PCAL9722::Input_Port_2 ]	= 0x3C;
+
+	bus.begin_batch();
+	gpio.output( 1, 0x81 );
+	CHECK( 0 == bus.n_calls );
+	CHECK( 0x3C == gpio.input( 2 ) );
+	CHECK( 1 == bus.n_calls );
+	CHECK( 2 == bus.n_last );
+	bus.end_batch();
+
+	CHECK( 0x81 == bus.regs[ PCAL9722::Output_Port_1 ] );
+}
+
+//	Failure of flush on full batch is returned to the access
+static void test_full_batch( void )
+{
+	STUB_I2C	i2c;
+	STUB_SPI	spi;
+	uint8_t		v	= 0x55;
+	uint8_t		f[ 3 ]	= { 0x40, 0x08, 0x55 };
+
+	i2c.begin_batch();
+
+	for ( int i = 0; i < STUB_I2C::MAX_MESSAGES; i++ )
+		CHECK( 1 == i2c.reg_w( 0x20, 0x10, &v, 1 ) );
+
+	i2c.fail	= true;
+	CHECK( -1 == i2c.reg_w( 0x20, 0x10, &v, 1 ) );
+	CHECK( 1 == i2c.n_calls );
+
+	for ( int i = 0; i < STUB_I2C::MAX_MESSAGES - 1; i++ )
+		i2c.reg_w( 0x20, 0x10, &v, 1 );
+
+	CHECK( -1 == i2c.reg_r( 0x20, 0x10, &v, 1 ) );
+	CHECK( 2 == i2c.n_calls );
+	i2c.fail	= false;
+	CHECK( 0 == i2c.end_batch() );
+
+	spi.begin_batch();
+
+	for ( int i = 0; i < STUB_SPI::MAX_MESSAGES; i++ )
+		CHECK( 3 == spi.txrx( f, NULL, 3 ) );
+
+	spi.fail	= true;
+	CHECK( -1 == spi.txrx( f, NULL, 3 ) );
+	CHECK( 1 == spi.n_calls );
+	spi.fail	= false;
+	CHECK( 0 == spi.end_batch() );
+}
+
+int main( void )
+{
+	test_i2c_layout();
+	test_i2c_batch();
+	test_i2c_device();
+	test_spi();
+	test_full_batch();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,105 @@
+/*
+ *	Test of LOGIC_CAPTURE ring handling and pin streams on SIM_TRANSPORT
+ */
+
+#include "PCAL6416A.h"
+#include "LOGIC_CAPTURE.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x20;
+
+//	Ring smaller than a record is refused instead of looping in record()
+static void test_small_ring( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6416A		gpio( ADDRESS );
+	uint8_t			ring[ LOGIC_CAPTURE::MAX_RECORD - 1 ];
+	LOGIC_CAPTURE	la( ring, sizeof( ring ) );
+
+	gpio.transport( &bus );
+	la.add( gpio );
+
+	CHECK( !la.begin() );
+
+	bus.poke( ADDRESS, PCAL6416A::Input_Port_0, 0x5A );
+	CHECK( !la.sample() );
+	CHECK( 0 == la.used() );
+}
+
+//	Ring of MAX_RECORD keeps the newest record and drops older ones
+static void test_minimum_ring( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6416A		gpio( ADDRESS );
+	uint8_t			ring[ LOGIC_CAPTURE::MAX_RECORD ];
+	LOGIC_CAPTURE	la( ring, sizeof( ring ) );
+
+	gpio.transport( &bus );
+	la.add( gpio );
+
+	CHECK( la.begin() );
+
+	for ( int i = 1; i <= 4; i++ ) {
+		bus.poke( ADDRESS, PCAL6416A::Input_Port_0, i );
+		CHECK( la.sample() );
+	}
+
+	CHECK( 0 < la.dropped() );
+	CHECK( la.used() <= LOGIC_CAPTURE::MAX_RECORD );
+}
+
+//	Resampled pin streams have port values at each time step
+static void test_pin_streams( void )
+{
+	static const int		STEPS	= 40;
+	static const int		STRIDE	= (STEPS + 7) / 8;
+	static const uint32_t	PERIOD	= 1000;
+	static const uint8_t	v[ 3 ][ 2 ]	= { { 0x5A, 0x81 }, { 0xA5, 0x81 }, { 0xA5, 0x3C } };
+
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6416A		gpio( ADDRESS );
+	uint8_t			ring[ 256 ];
+	uint8_t			streams[ 2 * 8 * STRIDE ];
+	LOGIC_CAPTURE	la( ring, sizeof( ring ) );
+
+	gpio.transport( &bus );
+	la.add( gpio );
+
+	bus.poke( ADDRESS, PCAL6416A::Input_Port_0, v[ 0 ][ 0 ] );
+	bus.poke( ADDRESS, PCAL6416A::Input_Port_1, v[ 0 ][ 1 ] );
+	CHECK( la.begin() );
+
+	//	Changes after 10ms and 25ms
+	delay( 10 );
+	bus.poke( ADDRESS, PCAL6416A::Input_Port_0, v[ 1 ][ 0 ] );
+	CHECK( la.sample() );
+	delay( 15 );
+	bus.poke( ADDRESS, PCAL6416A::Input_Port_1, v[ 2 ][ 1 ] );
+	CHECK( la.sample() );
+
+	CHECK( STEPS == la.pin_streams( 0, PERIOD, streams, STEPS ) );
+
+	for ( int t = 0; t < STEPS; t++ ) {
+		//	Changes are taken a bit after the delays. Time steps next to them are not checked
+		if ( ((10 <= t) && (t <= 11)) || ((25 <= t) && (t <= 26)) )
+			continue;
+
+		const uint8_t*	vp	= v[ (t < 10) ? 0 : ((t < 25) ? 1 : 2) ];
+		bool			ok	= true;
+
+		for ( int n = 0; n < 16; n++ )
+			ok	&= ((vp[ n / 8 ] >> (n % 8)) & 1) == ((streams[ n * STRIDE + t / 8 ] >> (t % 8)) & 1);
+
+		CHECK( ok );
+	}
+}
+
+int main( void )
+{
+	test_small_ring();
+	test_minimum_ring();
+	test_pin_streams();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,67 @@
+/*
+ *	Test of MUX_DISPLAY setting check and row refresh on SIM_TRANSPORT
+ */
+
+#include "PCAL6534.h"
+#include "MUX_DISPLAY.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x44 >> 1;
+
+//	No rows or no pins is refused, and refresh() does nothing
+static void test_invalid( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	uint64_t		select[ 1 ]	= { 0 };
+	MUX_DISPLAY		no_rows( gpio, select, 0, 0xFF );
+	MUX_DISPLAY		no_pins( gpio, select, 1, 0 );
+
+	gpio.transport( &bus );
+
+	CHECK( !no_rows.begin() );
+	CHECK( !no_pins.begin() );
+	CHECK( !no_rows.refresh() );
+	CHECK( !no_pins.refresh() );
+	CHECK( 0 == no_rows.max_rate( 400000 ) );
+	CHECK( 0 == bus.transactions() );
+}
+
+//	Rows are shown one by one with their select pin
+static void test_refresh( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	uint64_t		select[ 2 ]	= { 0x100, 0x200 };
+	MUX_DISPLAY		display( gpio, select, 2, 0xFF );
+
+	gpio.transport( &bus );
+	bus.poke( ADDRESS, PCAL6534::Configuration_port_0, 0xFF );
+	bus.poke( ADDRESS, PCAL6534::Configuration_port_1, 0xFF );
+
+	display.set( 0, 0x12 );
+	display.set( 1, 0x34 );
+	display.swap();
+	CHECK( display.begin( 1000 ) );
+
+	CHECK( 0x00 == bus.peek( ADDRESS, PCAL6534::Configuration_port_0 ) );
+	CHECK( 0xFC == bus.peek( ADDRESS, PCAL6534::Configuration_port_1 ) );
+
+	CHECK( display.refresh() );
+	CHECK( 0x12 == bus.peek( ADDRESS, PCAL6534::Output_Port_0 ) );
+	CHECK( 0x01 == bus.peek( ADDRESS, PCAL6534::Output_Port_1 ) );
+
+	delay( 1 );
+	CHECK( display.refresh() );
+	CHECK( 0x34 == bus.peek( ADDRESS, PCAL6534::Output_Port_0 ) );
+	CHECK( 0x02 == bus.peek( ADDRESS, PCAL6534::Output_Port_1 ) );
+}
+
+int main( void )
+{
+	test_invalid();
+	test_refresh();
+
+	return TEST_RESULT();
+}
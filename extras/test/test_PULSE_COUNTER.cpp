@@ -0,0 +1,109 @@
+/*
+ *	Test of PULSE_COUNTER bit-sliced counters and frequency on SIM_TRANSPORT
+ */
+
+#include "PCAL6534.h"
+#include "PULSE_COUNTER.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x44 >> 1;
+
+static const uint64_t	RISE	= (1ULL << 3) | (1ULL << 33);
+static const uint64_t	FALL	= (1ULL << 12) | (1ULL << 33);
+
+static void set_inputs( SIM_TRANSPORT& bus, uint64_t image )
+{
+	for ( int p = 0; p < 5; p++ )
+		bus.poke( ADDRESS, PCAL6534::Input_Port_0 + p, image >> (p * 8) );
+}
+
+//	Pulses on pins are counted by their edge settings
+static void pulses( SIM_TRANSPORT& bus, PULSE_COUNTER& pc, uint64_t pins, int n )
+{
+	for ( int i = 0; i < n; i++ ) {
+		set_inputs( bus, pins );
+		pc.service();
+		set_inputs( bus, 0 );
+		pc.service();
+	}
+}
+
+static void test_edges( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	PULSE_COUNTER	pc( gpio, RISE, FALL );
+
+	gpio.transport( &bus );
+	pc.begin();
+
+	pulses( bus, pc, RISE | FALL | (1ULL << 20), 5 );
+
+	CHECK( 5 == pc.count( 3 ) );
+	CHECK( 5 == pc.count( 12 ) );
+	CHECK( 10 == pc.count( 33 ) );		//	both edges
+	CHECK( 0 == pc.count( 20 ) );		//	not counted
+	CHECK( 0 == pc.count( -1 ) );
+	CHECK( 0 == pc.count( PULSE_COUNTER::MAX_PINS ) );
+
+	pc.clear();
+	CHECK( 0 == pc.count( 33 ) );
+}
+
+//	Bit planes are folded into counts before they overflow
+static void test_fold( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	PULSE_COUNTER	pc( gpio, RISE, FALL );
+	int				n	= (1 << PULSE_COUNTER::PLANES) + 123;
+
+	gpio.transport( &bus );
+	pc.begin();
+
+	pulses( bus, pc, (1ULL << 3) | (1ULL << 33), n );
+
+	CHECK( n == (int)pc.count( 3 ) );
+	CHECK( 2 * n == (int)pc.count( 33 ) );
+	CHECK( 0 == pc.count( 12 ) );
+}
+
+//	Frequency is taken from counts of last gate
+static void test_frequency( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	PULSE_COUNTER	pc( gpio, RISE, FALL );
+
+	gpio.transport( &bus );
+	pc.frequency_gate( 20000 );
+	pc.begin();
+
+	CHECK( 0.0 == pc.frequency( 3 ) );		//	no gate passed
+
+	pulses( bus, pc, 1ULL << 3, 100 );
+	delay( 25 );
+
+	//	100 edges in a gate of 20ms or a bit longer
+	float	f	= pc.frequency( 3 );
+
+	CHECK( (500.0 < f) && (f <= 5000.0) );
+	CHECK( f == pc.frequency( 3 ) );		//	same until next gate
+	CHECK( 0.0 == pc.frequency( 12 ) );
+	CHECK( 0.0 == pc.frequency( -1 ) );
+	CHECK( 0.0 == pc.frequency( PULSE_COUNTER::MAX_PINS ) );
+
+	delay( 25 );
+	CHECK( 0.0 == pc.frequency( 3 ) );		//	no edges in last gate
+	CHECK( 100 == pc.count( 3 ) );
+}
+
+int main( void )
+{
+	test_edges();
+	test_fold();
+	test_frequency();
+
+	return TEST_RESULT();
+}
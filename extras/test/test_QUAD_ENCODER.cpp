@@ -0,0 +1,116 @@
+/*
+ *	Test of QUAD_ENCODER pin setting and decoding on SIM_TRANSPORT
+ */
+
+#include "PCAL6534.h"
+#include "QUAD_ENCODER.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x44 >> 1;
+
+static void set_inputs( SIM_TRANSPORT& bus, uint64_t image )
+{
+	for ( int p = 0; p < 5; p++ )
+		bus.poke( ADDRESS, PCAL6534::Input_Port_0 + p, image >> (p * 8) );
+}
+
+//	Pins used by another encoder are refused
+static void test_add( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	QUAD_ENCODER	enc( gpio );
+
+	gpio.transport( &bus );
+
+	CHECK( 0 == enc.add( 4 ) );
+	CHECK( -1 == enc.add( 4 ) );		//	same pins
+	CHECK( -1 == enc.add( 5 ) );		//	phase-A on phase-B of channel 0
+	CHECK( -1 == enc.add( 3 ) );		//	phase-B on phase-A of channel 0
+	CHECK( 1 == enc.add( 6 ) );
+	CHECK( 2 == enc.add( 0 ) );
+	CHECK( -1 == enc.add( -1 ) );
+	CHECK( -1 == enc.add( 63 ) );		//	no phase-B pin
+	CHECK( 3 == enc.count() );
+
+	//	Overlapping pins in constructor: bit 1 is phase-B of bit 0 and ignored
+	QUAD_ENCODER	overlap( gpio, 0x07 );
+
+	CHECK( 2 == overlap.count() );
+}
+
+//	Direction, illegal transitions and interrupt without level change
+static void test_decode( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	QUAD_ENCODER	enc( gpio, 0x05 );	//	channel 0 on pin 0/1, channel 1 on pin 2/3
+
+	//	A/B states of a forward cycle
+	static const uint8_t	fwd[ 4 ]	= { 0x1, 0x3, 0x2, 0x0 };
+
+	gpio.transport( &bus );
+	set_inputs( bus, 0 );
+	enc.begin();
+
+	CHECK( 0x0F == (0x0F & bus.peek( ADDRESS, PCAL6534::Configuration_port_0 )) );
+	CHECK( 0x00 == (0x0F & bus.peek( ADDRESS, PCAL6534::Interrupt_mask_register_port_0 )) );
+
+	//	Channel 0 forward, channel 1 backward
+	for ( int i = 0; i < 8; i++ ) {
+		set_inputs( bus, fwd[ i % 4 ] | (fwd[ 3 - ((i + 1) % 4) ] << 2) );
+		CHECK( 0x05 == enc.service() );
+	}
+
+	CHECK( 8 == enc.position( 0 ) );
+	CHECK( -8 == enc.position( 1 ) );
+
+	//	Both phases changed: missed and position is kept
+	set_inputs( bus, 0x3 );
+	CHECK( 0 == enc.service() );
+	CHECK( 1 == (int)enc.missed( 0 ) );
+	CHECK( 8 == enc.position( 0 ) );
+
+	//	Interrupt without level change
+	bus.poke( ADDRESS, PCAL6534::Interrupt_status_register_port_0, 0x04 );
+	CHECK( 0 == enc.service() );
+	CHECK( 1 == (int)enc.missed( 1 ) );
+	CHECK( -8 == enc.position( 1 ) );
+	bus.poke( ADDRESS, PCAL6534::Interrupt_status_register_port_0, 0x00 );
+
+	enc.position( 0, 100 );
+	set_inputs( bus, 0x2 );				//	0x3 -> 0x2: forward
+	enc.service();
+	CHECK( 101 == enc.position( 0 ) );
+}
+
+//	Encoders beyond MAX_ENCODERS are dropped
+static void test_max_encoders( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	QUAD_ENCODER	enc( gpio, 0x5555555555ULL );	//	20 encoders on pin 0, 2, ... 38
+
+	gpio.transport( &bus );
+	set_inputs( bus, 0 );
+	enc.begin();
+
+	CHECK( QUAD_ENCODER::MAX_ENCODERS == enc.count() );
+	CHECK( -1 == enc.add( 40 ) );
+
+	//	Last channel is on pin 32. Pin 34 is not decoded
+	set_inputs( bus, (1ULL << 32) | (1ULL << 34) );
+	CHECK( (1ULL << 32) == enc.service() );
+	CHECK( 1 == enc.position( QUAD_ENCODER::MAX_ENCODERS - 1 ) );
+	CHECK( 0x03 == (0x0F & bus.peek( ADDRESS, PCAL6534::Configuration_port_4 )) );
+}
+
+int main( void )
+{
+	test_add();
+	test_decode();
+	test_max_encoders();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,101 @@
+/*
+ *	Test of SHIFT_OUT pin setting, shared port and burst length on SIM_TRANSPORT
+ */
+
+#include "PCAL6416A.h"
+#include "PCAL6534.h"
+#include "SHIFT_OUT.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x20;
+
+/* Transport which records largest write */
+class LARGEST : public GPIO_TRANSPORT {
+public:
+	LARGEST( GPIO_TRANSPORT& bus ) : tp( bus ), largest( 0 ) {}
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+	{
+		if ( largest < size )
+			largest	= size;
+
+		return tp.reg_w( address, reg, data, size );
+	}
+
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+	{
+		return tp.reg_r( address, reg, data, size );
+	}
+
+	GPIO_TRANSPORT&	tp;
+	int				largest;
+};
+
+//	Clock or latch in data pins is refused
+static void test_overlap( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6416A		gpio( ADDRESS );
+	SHIFT_OUT		clk_in_data( gpio, 0, 0x03, 1 );
+	SHIFT_OUT		latch_in_data( gpio, 0, 0x03, 2, 0 );
+	SHIFT_OUT		same_pin( gpio, 0, 0x01, 2, 2 );
+	SHIFT_OUT		good( gpio, 0, 0x01, 1, 2 );
+	uint8_t			d	= 0xA5;
+
+	gpio.transport( &bus );
+
+	CHECK( !clk_in_data.begin() );
+	CHECK( !latch_in_data.begin() );
+	CHECK( !same_pin.begin() );
+	CHECK( good.begin() );
+
+	int	n	= bus.transactions();
+
+	clk_in_data.write( &d, 1 );
+	CHECK( n == (int)bus.transactions() );
+}
+
+//	Other pins changed after begin() are kept by bursts
+static void test_shared_port( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6416A		gpio( ADDRESS );
+	SHIFT_OUT		so( gpio, 0, 0x01, 1, 2 );
+	uint8_t			d	= 0xFF;
+
+	gpio.transport( &bus );
+	so.begin();
+
+	gpio.write_port( OUT, (uint8_t)0x80, 0 );
+	so.write( &d, 1 );
+
+	CHECK( 0x80 == bus.peek( ADDRESS, PCAL6416A::Output_Port_0 ) );
+}
+
+//	Register address and a burst fit in a Wire buffer
+static void test_burst_length( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	LARGEST			lt( bus );
+	PCAL6534		gpio( ADDRESS );
+	SHIFT_OUT		so( gpio, 0, 0x01, 1, 2 );
+	uint8_t			d[ 8 ]	= { 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00 };
+
+	gpio.transport( &lt );
+	so.begin();
+	so.write( d, sizeof( d ) );
+
+	CHECK( 0 == SHIFT_OUT::BURST_LENGTH % 2 );
+	CHECK( lt.largest + 1 <= GPIO_NXP_WIRE_BUFFER );
+	CHECK( SHIFT_OUT::BURST_LENGTH == lt.largest );
+}
+
+int main( void )
+{
+	test_overlap();
+	test_shared_port();
+	test_burst_length();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,52 @@
+/*
+ *	Test of STEPPER state handling on SIM_TRANSPORT
+ */
+
+#include "PCAL6416A.h"
+#include "STEPPER.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x20;
+
+//	Bus rate is not asked when no motor is added
+static void test_no_motor( void )
+{
+	PCAL6416A	gpio( ADDRESS );
+	STEPPER		st( gpio, 1000 );
+
+	CHECK( 1000 == st.max_step_rate( 400000 ) );
+}
+
+//	After release(), a new move starts from standstill without old ramp
+static void test_release( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6416A		gpio( ADDRESS );
+	STEPPER			st( gpio, 1000 );
+	int				m;
+
+	gpio.transport( &bus );
+	m	= st.add( 0, 1, 2, 3 );
+	st.speed( m, 500, 1000 );
+	st.begin();
+
+	st.move( m, 1000 );
+
+	for ( int i = 0; i < 300; i++ )
+		st.tick();
+
+	st.release( m );
+	st.move( m, 1000 );
+	st.stop( m );
+
+	CHECK( !st.busy( m ) );
+}
+
+int main( void )
+{
+	test_no_motor();
+	test_release();
+
+	return TEST_RESULT();
+}
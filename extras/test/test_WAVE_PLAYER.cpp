@@ -0,0 +1,155 @@
+/*
+ *	Test of WAVE_PLAYER timing, looping and trigger on SIM_TRANSPORT
+ */
+
+#include "PCAL6534.h"
+#include "WAVE_PLAYER.h"
+#include "SIM_TRANSPORT.h"
+#include "TEST.h"
+
+static const uint8_t	ADDRESS	= 0x44 >> 1;
+
+//	Record time is taken in run() and writes are logged in transport, a bit later
+static const uint32_t	JITTER	= 100;
+
+/* Transport which records writes to Output_Port_0 with time */
+class RECORDER : public GPIO_TRANSPORT {
+public:
+	static constexpr int	MAX_LOG	= 64;
+
+	RECORDER( GPIO_TRANSPORT& bus ) : tp( bus ), n_log( 0 ), largest( 0 ) {}
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+	{
+		if ( largest < size )
+			largest	= size;
+
+		if ( PCAL6534::Output_Port_0 == reg ) {
+			for ( int i = 0; (i < size) && (n_log < MAX_LOG); i++ ) {
+				value[ n_log ]	= data[ i ];
+				time[ n_log++ ]	= micros();
+			}
+		}
+
+		return tp.reg_w( address, reg, data, size );
+	}
+
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+	{
+		return tp.reg_r( address, reg, data, size );
+	}
+
+	GPIO_TRANSPORT&	tp;
+	int				n_log;
+	int				largest;
+	uint8_t			value[ MAX_LOG ];
+	uint32_t		time[ MAX_LOG ];
+};
+
+static const uint8_t	timed[]	= {
+	0xE8, 0x03, 0x01,	//	hold 1ms
+	0xD0, 0x07, 0x02,	//	hold 2ms
+	0x00, 0x00, 0x04,
+};
+
+static const uint8_t	fast[]	= {
+	0x00, 0x00, 0x11,
+	0x00, 0x00, 0x22,
+	0x00, 0x00, 0x44,
+};
+
+//	Only pins driven by the table are set to output
+static void test_begin( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	PCAL6534		gpio( ADDRESS );
+	WAVE_PLAYER		player( gpio, timed, 3 );
+
+	gpio.transport( &bus );
+	bus.poke( ADDRESS, PCAL6534::Configuration_port_0, 0xFF );
+	bus.poke( ADDRESS, PCAL6534::Configuration_port_1, 0xFF );
+
+	player.begin();
+
+	CHECK( 0xF8 == bus.peek( ADDRESS, PCAL6534::Configuration_port_0 ) );
+	CHECK( 0xFF == bus.peek( ADDRESS, PCAL6534::Configuration_port_1 ) );
+}
+
+//	Each record is held for its delay
+static void test_timing( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	RECORDER		rec( bus );
+	PCAL6534		gpio( ADDRESS );
+	WAVE_PLAYER		player( gpio, timed, 3 );
+
+	gpio.transport( &rec );
+	player.play();
+
+	CHECK( 3 == rec.n_log );
+	CHECK( (0x01 == rec.value[ 0 ]) && (0x02 == rec.value[ 1 ]) && (0x04 == rec.value[ 2 ]) );
+	CHECK( 1000 - JITTER <= rec.time[ 1 ] - rec.time[ 0 ] );
+	CHECK( 2000 - JITTER <= rec.time[ 2 ] - rec.time[ 1 ] );
+	CHECK( 3000 - JITTER <= rec.time[ 2 ] - rec.time[ 0 ] );
+	CHECK( !player.busy() );
+}
+
+//	Table is played given times, and '0' delay records are sent in bursts
+static void test_loops( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	RECORDER		rec( bus );
+	PCAL6534		gpio( ADDRESS );
+	WAVE_PLAYER		player( gpio, fast, 3 );
+
+	gpio.transport( &rec );
+	player.play( 20 );
+
+	CHECK( 60 == rec.n_log );
+	CHECK( (0x11 == rec.value[ 0 ]) && (0x44 == rec.value[ 2 ]) && (0x11 == rec.value[ 3 ]) && (0x44 == rec.value[ 59 ]) );
+	CHECK( WAVE_PLAYER::BURST_LENGTH == rec.largest );
+	CHECK( rec.largest + 1 <= GPIO_NXP_WIRE_BUFFER );
+
+	//	Endless until stop()
+	player.start( 0 );
+
+	for ( int i = 0; i < 10; i++ )
+		CHECK( player.run() );
+
+	player.stop();
+	CHECK( !player.run() );
+	CHECK( !player.busy() );
+}
+
+//	Playback starts when trigger pins have the level
+static void test_trigger( void )
+{
+	SIM_TRANSPORT	bus( 0, 0 );
+	RECORDER		rec( bus );
+	PCAL6534		gpio( ADDRESS );
+	WAVE_PLAYER		player( gpio, fast, 3 );
+
+	gpio.transport( &rec );
+	bus.poke( ADDRESS, PCAL6534::Input_Port_1, 0x01 );
+
+	player.arm( 0x100, 0x000 );
+	CHECK( player.run() );
+	CHECK( player.run() );
+	CHECK( 0 == rec.n_log );
+	CHECK( !player.busy() );
+
+	bus.poke( ADDRESS, PCAL6534::Input_Port_1, 0x00 );
+	CHECK( !player.run() );
+	CHECK( 3 == rec.n_log );
+	CHECK( (0x11 == rec.value[ 0 ]) && (0x44 == rec.value[ 2 ]) );
+}
+
+int main( void )
+{
+	test_begin();
+	test_timing();
+	test_loops();
+	test_trigger();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,179 @@
+/** BIT_OPS: bit manipulation kernels for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_BIT_OPS_H
+#define ARDUINO_GPIO_NXP_ARD_BIT_OPS_H
+
+#include <stdint.h>
+
+#if defined( __SSE2__ ) && !defined( ARDUINO )
+#include <emmintrin.h>
+#endif
+
+/** BIT_OPS class
+ *
+ *  @class BIT_OPS
+ *
+ *	Branch-free SWAR kernels used for bit images of GPIO ports
+ */
+class BIT_OPS {
+public:
+	/** Bit interleave (Morton spread)
+	 *
+	 *	Bit 'n' of input is moved to bit '2n' of output. Odd bits of output are '0'
+	 *
+	 * @param v	Input value
+	 * @return	Spread value
+	 */
+	static inline uint64_t	interleave( uint32_t v )
+	{
+		uint64_t	x	= v;
+
+		x	= (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+		x	= (x | (x <<  8)) & 0x00FF00FF00FF00FFULL;
+		x	= (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0FULL;
+		x	= (x | (x <<  2)) & 0x3333333333333333ULL;
+		x	= (x | (x <<  1)) & 0x5555555555555555ULL;
+
+		return x;
+	}
+
+	/** Bit deinterleave (Morton compact)
+	 *
+	 *	Bit '2n' of input is moved to bit 'n' of output. Odd bits of input are ignored
+	 *
+	 * @param v	Input value
+	 * @return	Compacted value
+	 */
+	static inline uint32_t	deinterleave( uint64_t v )
+	{
+		uint64_t	x	= v & 0x5555555555555555ULL;
+
+		x	= (x | (x >>  1)) & 0x3333333333333333ULL;
+		x	= (x | (x >>  2)) & 0x0F0F0F0F0F0F0F0FULL;
+		x	= (x | (x >>  4)) & 0x00FF00FF00FF00FFULL;
+		x	= (x | (x >>  8)) & 0x0000FFFF0000FFFFULL;
+		x	= (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+
+		return (uint32_t)x;
+	}
+
+	/** 8x8 bit matrix transpose
+	 *
+	 *	Byte 'i' of input is row 'i'. Bit 'j' of byte 'i' is moved to bit 'i' of byte 'j'
+	 *
+	 * @param x	Input matrix
+	 * @return	Transposed matrix
+	 */
+	static inline uint64_t	transpose8( uint64_t x )
+	{
+		uint64_t	t;
+
+		t	= (x ^ (x >>  7)) & 0x00AA00AA00AA00AAULL;
+		x	= x ^ t ^ (t <<  7);
+		t	= (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+		x	= x ^ t ^ (t << 14);
+		t	= (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+		x	= x ^ t ^ (t << 28);
+
+		return x;
+	}
+
+	/** Port snapshots to pin streams
+	 *
+	 *	Snapshots are 'n_ports' bytes per time step. 
+	 *	Stream of pin 'n' (bit 'n % 8' of port 'n / 8') starts at streams[ n * stride ] 
+	 *	and bit 't % 8' of its byte 't / 8' is the pin state at time step 't'
+	 *
+	 * @param snapshots	Port snapshots
+	 * @param n_ports	Number of ports
+	 * @param n_samples	Number of time steps
+	 * @param streams	Buffer for pin streams. Should have 'n_ports * 8 * stride' bytes
+	 * @param stride	Bytes of a pin stream. '0' for '(n_samples + 7) / 8'. 
+	 *					Larger value is used to convert a part of longer streams
+	 */
+	static inline void	ports_to_pins( const uint8_t* snapshots, int n_ports, int n_samples, uint8_t* streams, int stride = 0 )
+	{
+		int	t		= 0;
+
+		if ( !stride )
+			stride	= (n_samples + 7) / 8;
+
+#if defined( __SSE2__ ) && !defined( ARDUINO )
+		//	16 time steps of a port at once: MSBs of 16 bytes are taken by movemask
+		for ( ; t + 16 <= n_samples; t += 16 ) {
+			for ( int p = 0; p < n_ports; p++ ) {
+				uint8_t	col[ 16 ];
+
+				for ( int i = 0; i < 16; i++ )
+					col[ i ]	= snapshots[ (t + i) * n_ports + p ];
+
+				__m128i	x	= _mm_loadu_si128( (const __m128i*)col );
+
+				for ( int b = 7; 0 <= b; b-- ) {
+					int			m	= _mm_movemask_epi8( x );
+					uint8_t*	sp	= streams + (p * 8 + b) * stride + t / 8;
+
+					sp[ 0 ]	= m;
+					sp[ 1 ]	= m >> 8;
+					x		= _mm_add_epi8( x, x );
+				}
+			}
+		}
+#endif
+
+		for ( ; t < n_samples; t += 8 ) {
+			int	n	= (8 < n_samples - t) ? 8 : n_samples - t;
+
+			for ( int p = 0; p < n_ports; p++ ) {
+				uint64_t	x	= 0;
+
+				for ( int i = 0; i < n; i++ )
+					x	|= (uint64_t)snapshots[ (t + i) * n_ports + p ] << (i * 8);
+
+				x	= transpose8( x );
+
+				for ( int b = 0; b < 8; b++ )
+					streams[ (p * 8 + b) * stride + t / 8 ]	= x >> (b * 8);
+			}
+		}
+	}
+
+	/** Pin streams to port snapshots
+	 *
+	 *	Reverse of ports_to_pins()
+	 *
+	 * @param streams	Pin streams
+	 * @param n_ports	Number of ports
+	 * @param n_samples	Number of time steps
+	 * @param snapshots	Buffer for port snapshots. Should have 'n_ports * n_samples' bytes
+	 * @param stride	Bytes of a pin stream. '0' for '(n_samples + 7) / 8'
+	 */
+	static inline void	pins_to_ports( const uint8_t* streams, int n_ports, int n_samples, uint8_t* snapshots, int stride = 0 )
+	{
+		if ( !stride )
+			stride	= (n_samples + 7) / 8;
+
+		for ( int t = 0; t < n_samples; t += 8 ) {
+			int	n	= (8 < n_samples - t) ? 8 : n_samples - t;
+
+			for ( int p = 0; p < n_ports; p++ ) {
+				uint64_t	x	= 0;
+
+				for ( int b = 0; b < 8; b++ )
+					x	|= (uint64_t)streams[ (p * 8 + b) * stride + t / 8 ] << (b * 8);
+
+				x	= transpose8( x );
+
+				for ( int i = 0; i < n; i++ )
+					snapshots[ (t + i) * n_ports + p ]	= x >> (i * 8);
+			}
+		}
+	}
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_BIT_OPS_H
@@ -0,0 +1,51 @@
+#include "BUS_LOCK.h"
+
+BUS_LOCK::BUS_LOCK()
+{
+#if defined( GPIO_NXP_LOCK_FREERTOS )
+	mutex	= xSemaphoreCreateRecursiveMutex();
+#elif defined( GPIO_NXP_LOCK_PICO )
+	recursive_mutex_init( &mutex );
+#endif
+}
+
+BUS_LOCK::~BUS_LOCK()
+{
+#if defined( GPIO_NXP_LOCK_FREERTOS )
+	vSemaphoreDelete( mutex );
+#endif
+}
+
+void BUS_LOCK::lock( void )
+{
+#if defined( GPIO_NXP_LOCK_FREERTOS )
+	xSemaphoreTakeRecursive( mutex, portMAX_DELAY );
+#elif defined( GPIO_NXP_LOCK_PICO )
+	recursive_mutex_enter_blocking( &mutex );
+#elif defined( GPIO_NXP_LOCK_STD )
+	mutex.lock();
+#endif
+}
+
+void BUS_LOCK::unlock( void )
+{
+#if defined( GPIO_NXP_LOCK_FREERTOS )
+	xSemaphoreGiveRecursive( mutex );
+#elif defined( GPIO_NXP_LOCK_PICO )
+	recursive_mutex_exit( &mutex );
+#elif defined( GPIO_NXP_LOCK_STD )
+	mutex.unlock();
+#endif
+}
+
+BUS_LOCK::guard::guard( BUS_LOCK* lock ) : lp( lock )
+{
+	if ( lp )
+		lp->lock();
+}
+
+BUS_LOCK::guard::~guard()
+{
+	if ( lp )
+		lp->unlock();
+}
@@ -0,0 +1,80 @@
+/** BUS_LOCK: bus arbitration for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_BUS_LOCK_H
+#define ARDUINO_GPIO_NXP_ARD_BUS_LOCK_H
+
+#include <stdint.h>
+
+#if defined( ESP32 )
+	#define	GPIO_NXP_LOCK_FREERTOS
+	#include <freertos/FreeRTOS.h>
+	#include <freertos/semphr.h>
+#elif defined( ARDUINO_ARCH_RP2040 )
+	#define	GPIO_NXP_LOCK_PICO
+	#include <pico/mutex.h>
+#elif !defined( ARDUINO )
+	#define	GPIO_NXP_LOCK_STD
+	#include <mutex>
+#endif
+
+/** BUS_LOCK class
+ *	
+ *  @class BUS_LOCK
+ *
+ *	Recursive lock for a bus. 
+ *	GPIO devices sharing a bus should share one BUS_LOCK instance (see GPIO_base::bus_lock()). 
+ *	Each GPIO_base method takes the lock while it accesses the device. 
+ *	To keep a sequence of accesses atomic with one lock, hold a BUS_LOCK::guard over the sequence. 
+ *
+ *	FreeRTOS mutex is used on ESP32, pico-sdk mutex on RP2040 and std::recursive_mutex on host build. 
+ *	On other (single thread) targets, this class does nothing. 
+ *	Lock cannot be taken in ISR. Use SPSC_QUEUE to pass requests from ISR. 
+ */
+class BUS_LOCK {
+public:
+	/** Constractor */
+	BUS_LOCK();
+
+	/** Destractor */
+	~BUS_LOCK();
+
+	/** Take the lock. Blocks until available */
+	void	lock( void );
+
+	/** Release the lock */
+	void	unlock( void );
+
+	/** Scoped lock
+	 *	
+	 *	Takes the lock in constructor and releases it in destructor. 
+	 *	Does nothing if given pointer is NULL
+	 */
+	class guard {
+	public:
+		guard( BUS_LOCK* lock );
+		~guard();
+	private:
+		BUS_LOCK*	lp;
+		guard( const guard& );
+		guard&	operator=( const guard& );
+	};
+
+private:
+#if defined( GPIO_NXP_LOCK_FREERTOS )
+	SemaphoreHandle_t		mutex;
+#elif defined( GPIO_NXP_LOCK_PICO )
+	recursive_mutex_t		mutex;
+#elif defined( GPIO_NXP_LOCK_STD )
+	std::recursive_mutex	mutex;
+#endif
+
+	BUS_LOCK( const BUS_LOCK& );
+	BUS_LOCK&	operator=( const BUS_LOCK& );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_BUS_LOCK_H
@@ -0,0 +1,311 @@
+#include "BUS_MANAGER.h"
+
+//	I2C clock steps: Fast-mode Plus, Fast-mode and Standard-mode
+static const uint32_t	clock_steps[]	= { 1000000, 400000, 100000 };
+static const int		n_clock_steps	= sizeof( clock_steps ) / sizeof( clock_steps[ 0 ] );
+
+void BUS_REQUEST::execute( void )
+{
+	switch ( op ) {
+		case WRITE_PORT:
+			dev->write_port( w, data );
+			break;
+		case READ_PORT:
+			dev->read_port( w, data );
+			break;
+		case WRITE_SINGLE:
+			dev->write_port( w, data[ 0 ], port );
+			break;
+		case READ_SINGLE:
+			data[ 0 ]	= dev->read_port( w, port );
+			break;
+	}
+
+	if ( callback )
+		callback( this );
+}
+
+BUS_MANAGER::BUS_MANAGER( policy p )
+	: pol( p ), n_buses( 0 ), n_devices( 0 ), next_bus( 0 )
+{
+}
+
+int BUS_MANAGER::add_bus( TwoWire& wire )
+{
+	if ( MAX_BUSES <= n_buses )
+		return -1;
+
+	bus_list[ n_buses ].wire	= &wire;
+	bus_list[ n_buses ].spi		= NULL;
+	bus_list[ n_buses ].clock	= 100000;
+	bus_list[ n_buses ].n_queue	= 0;
+
+	return n_buses++;
+}
+
+int BUS_MANAGER::add_bus( SPIClass& spi )
+{
+	if ( MAX_BUSES <= n_buses )
+		return -1;
+
+	bus_list[ n_buses ].wire	= NULL;
+	bus_list[ n_buses ].spi		= &spi;
+	bus_list[ n_buses ].clock	= 0;
+	bus_list[ n_buses ].n_queue	= 0;
+
+	return n_buses++;
+}
+
+bool BUS_MANAGER::add( GPIO_base& gpio, int b, uint8_t priority )
+{
+	if ( (MAX_DEVICES <= n_devices) || (b < 0) || (n_buses <= b) )
+		return false;
+
+	//	Device with transport doesn't use Wire/SPI instance. Others should be on the bus
+	if ( !gpio.transport() && ((gpio.wire() != bus_list[ b ].wire) || (gpio.spi() != bus_list[ b ].spi)) )
+		return false;
+
+	dev_list[ n_devices ].dev		= &gpio;
+	dev_list[ n_devices ].bus		= b;
+	dev_list[ n_devices ].priority	= priority;
+	n_devices++;
+
+	gpio.bus_lock( &bus_list[ b ].lock );
+
+	if ( bus_list[ b ].wire )
+		gpio.bus_clock( bus_list[ b ].clock );
+
+	return true;
+}
+
+int BUS_MANAGER::bus_of( GPIO_base& gpio )
+{
+	device*	dp	= find( &gpio );
+
+	return dp ? dp->bus : -1;
+}
+
+void BUS_MANAGER::begin( void )
+{
+	for ( int i = 0; i < n_buses; i++ ) {
+		if ( bus_list[ i ].wire )
+			bus_list[ i ].wire->begin();
+		else
+			bus_list[ i ].spi->begin();
+	}
+}
+
+uint32_t BUS_MANAGER::negotiate_clock( int b, uint32_t max, int repeat )
+{
+	bus_state&		bs	= bus_list[ b ];
+	BUS_LOCK::guard	g( &bs.lock );
+	uint64_t		saved[ MAX_DEVICES ];
+	uint32_t		chosen	= 0;
+
+	if ( !bs.wire )
+		return 0;
+
+	for ( int i = 0; i < n_devices; i++ )
+		if ( (dev_list[ i ].bus == b) && (dev_list[ i ].dev->max_clock() < max) )
+			max	= dev_list[ i ].dev->max_clock();
+
+	//	Save registers used for the test at safe speed
+	set_clock( b, clock_steps[ n_clock_steps - 1 ] );
+
+	for ( int i = 0; i < n_devices; i++ )
+		if ( (dev_list[ i ].bus == b) && dev_list[ i ].dev->has_register( POLARITY ) )
+			saved[ i ]	= dev_list[ i ].dev->read_image( POLARITY );
+
+	for ( int s = 0; !chosen && (s < n_clock_steps); s++ ) {
+		bool	pass	= true;
+
+		if ( max < clock_steps[ s ] )
+			continue;
+
+		set_clock( b, clock_steps[ s ] );
+
+		for ( int i = 0; pass && (i < n_devices); i++ )
+			if ( dev_list[ i ].bus == b )
+				pass	= dev_list[ i ].dev->link_test( repeat );
+
+		if ( pass )
+			chosen	= clock_steps[ s ];
+	}
+
+	if ( !chosen )
+		set_clock( b, clock_steps[ n_clock_steps - 1 ] );
+
+	for ( int i = 0; i < n_devices; i++ )
+		if ( (dev_list[ i ].bus == b) && dev_list[ i ].dev->has_register( POLARITY ) )
+			dev_list[ i ].dev->write_image( POLARITY, saved[ i ] );
+
+	return chosen;
+}
+
+uint32_t BUS_MANAGER::fallback( int b )
+{
+	BUS_LOCK::guard	g( &bus_list[ b ].lock );
+
+	for ( int s = 0; s < n_clock_steps - 1; s++ ) {
+		if ( clock_steps[ s ] <= bus_list[ b ].clock ) {
+			set_clock( b, clock_steps[ s + 1 ] );
+			break;
+		}
+	}
+
+	return bus_list[ b ].clock;
+}
+
+uint32_t BUS_MANAGER::clock( int b )
+{
+	return bus_list[ b ].clock;
+}
+
+bool BUS_MANAGER::submit( const BUS_REQUEST& req )
+{
+	device*	dp	= find( req.dev );
+
+	if ( !dp )
+		return false;
+
+	bus_state&		b	= bus_list[ dp->bus ];
+	BUS_LOCK::guard	g( &b.queue_lock );
+
+	if ( QUEUE_LENGTH <= b.n_queue )
+		return false;
+
+	b.queue[ b.n_queue++ ]	= req;
+
+	return true;
+}
+
+bool BUS_MANAGER::submit_from_isr( const BUS_REQUEST& req )
+{
+	device*	dp	= find( req.dev );
+
+	if ( !dp )
+		return false;
+
+	return bus_list[ dp->bus ].isr_queue.push( req );
+}
+
+BUS_LOCK* BUS_MANAGER::bus_lock( int b )
+{
+	return &bus_list[ b ].lock;
+}
+
+bool BUS_MANAGER::submit( GPIO_base& gpio, BUS_REQUEST::type op, access_word w, uint8_t* data, int port, void (*callback)( BUS_REQUEST* ) )
+{
+	device*		dp	= find( &gpio );
+	BUS_REQUEST	req;
+
+	if ( !dp )
+		return false;
+
+	req.dev			= &gpio;
+	req.op			= op;
+	req.w			= w;
+	req.port		= port;
+	req.priority	= dp->priority;
+	req.data		= data;
+	req.callback	= callback;
+	req.user		= NULL;
+
+	return submit( req );
+}
+
+int BUS_MANAGER::run( void )
+{
+	int	count	= 0;
+
+	for ( int i = 0; i < n_buses; i++ ) {
+		if ( run_bus( next_bus ) )
+			count++;
+
+		next_bus	= (next_bus + 1) % n_buses;
+	}
+
+	return count;
+}
+
+int BUS_MANAGER::run_all( void )
+{
+	int	count	= 0;
+	int	n;
+
+	while ( (n = run()) )
+		count	+= n;
+
+	return count;
+}
+
+bool BUS_MANAGER::run_bus( int b )
+{
+	BUS_REQUEST		req;
+	BUS_LOCK::guard	g( &bus_list[ b ].lock );
+
+	if ( !bus_list[ b ].isr_queue.pop( &req ) && !take( b, &req ) )
+		return false;
+
+	req.execute();
+
+	return true;
+}
+
+int BUS_MANAGER::pending( int b )
+{
+	return bus_list[ b ].n_queue + bus_list[ b ].isr_queue.size();
+}
+
+int BUS_MANAGER::buses( void )
+{
+	return n_buses;
+}
+
+BUS_MANAGER::device* BUS_MANAGER::find( GPIO_base* gpio )
+{
+	for ( int i = 0; i < n_devices; i++ )
+		if ( dev_list[ i ].dev == gpio )
+			return &dev_list[ i ];
+
+	return NULL;
+}
+
+void BUS_MANAGER::set_clock( int b, uint32_t clock )
+{
+	if ( !bus_list[ b ].wire )
+		return;
+
+	bus_list[ b ].wire->setClock( clock );
+	bus_list[ b ].clock	= clock;
+
+	//	Devices restore this clock after bus recovery
+	for ( int i = 0; i < n_devices; i++ )
+		if ( dev_list[ i ].bus == b )
+			dev_list[ i ].dev->bus_clock( clock );
+}
+
+bool BUS_MANAGER::take( int b, BUS_REQUEST* rp )
+{
+	bus_state&		bs		= bus_list[ b ];
+	BUS_LOCK::guard	g( &bs.queue_lock );
+	int				index	= 0;
+
+	if ( !bs.n_queue )
+		return false;
+
+	if ( PRIORITY == pol ) {
+		for ( int i = 1; i < bs.n_queue; i++ )
+			if ( bs.queue[ index ].priority < bs.queue[ i ].priority )
+				index	= i;
+	}
+
+	*rp	= bs.queue[ index ];
+
+	for ( int i = index + 1; i < bs.n_queue; i++ )
+		bs.queue[ i - 1 ]	= bs.queue[ i ];
+
+	bs.n_queue--;
+
+	return true;
+}
@@ -0,0 +1,242 @@
+/** BUS_MANAGER: multi-bus request scheduler for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_BUS_MANAGER_H
+#define ARDUINO_GPIO_NXP_ARD_BUS_MANAGER_H
+
+#include <GPIO_NXP.h>
+#include <SPI.h>
+#include <SPSC_QUEUE.h>
+
+/** BUS_REQUEST struct
+ *
+ *	A register access request to a GPIO device
+ */
+struct BUS_REQUEST {
+	/** Request types */
+	enum type : uint8_t {
+		WRITE_PORT,		/**< write_port( w, data ): all ports */
+		READ_PORT,		/**< read_port( w, data ): all ports */
+		WRITE_SINGLE,	/**< write_port( w, data[ 0 ], port ) */
+		READ_SINGLE,	/**< data[ 0 ] = read_port( w, port ) */
+	};
+
+	GPIO_base*		dev;
+	type			op;
+	access_word		w;
+	uint8_t			port;
+	uint8_t			priority;
+	uint8_t*		data;
+	void			(*callback)( BUS_REQUEST* rp );
+	void*			user;
+
+	/** Execute the request on caller context */
+	void	execute( void );
+};
+
+/** BUS_MANAGER class
+ *
+ *  @class BUS_MANAGER
+ *
+ *	Owns several buses (TwoWire and/or SPIClass instances) and GPIO devices on them.
+ *	Requests are queued per bus and issued by run(), interleaving the buses in round-robin.
+ *	In a bus, requests are taken in FIFO order or in priority order.
+ *
+ *	Since Arduino Wire/SPI transfers are blocking, run_bus() can be called from separated
+ *	task for each bus on RTOS targets to overlap transfers on independent buses.
+ *
+ *	Each bus has a BUS_LOCK which is shared by devices on the bus. 
+ *	Requests from ISR can be passed by submit_from_isr() through a lock-free queue. 
+ */
+class BUS_MANAGER {
+public:
+	/** Maximum number of buses */
+	static constexpr int	MAX_BUSES		= 4;
+
+	/** Maximum number of devices */
+	static constexpr int	MAX_DEVICES		= 16;
+
+	/** Number of requests can be queued in a bus */
+	static constexpr int	QUEUE_LENGTH	= 8;
+
+	/** Scheduling policy in a bus */
+	enum policy {
+		ROUND_ROBIN,
+		PRIORITY,
+	};
+
+	/** Constractor
+	 *
+	 * @param p	Scheduling policy in a bus
+	 */
+	BUS_MANAGER( policy p = ROUND_ROBIN );
+
+	/** Add I2C bus
+	 *
+	 * @param wire	TwoWire instance
+	 * @return	Bus ID. -1 if no space
+	 */
+	int		add_bus( TwoWire& wire );
+
+	/** Add SPI bus
+	 *
+	 * @param spi	SPIClass instance
+	 * @return	Bus ID. -1 if no space
+	 */
+	int		add_bus( SPIClass& spi );
+
+	/** Add device on a bus
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param bus		Bus ID
+	 * @param priority	Default priority of requests to this device. Larger number is higher
+	 * @return	'true' if added. 'false' if the device is not on the bus (TwoWire/SPIClass instance differs)
+	 */
+	bool	add( GPIO_base& gpio, int bus, uint8_t priority = 0 );
+
+	/** Bus of device
+	 *
+	 * @param gpio	GPIO device instance
+	 * @return	Bus ID. -1 if the device is not added
+	 */
+	int		bus_of( GPIO_base& gpio );
+
+	/** Begin all buses */
+	void	begin( void );
+
+	/** Negotiate I2C clock
+	 *
+	 *	Finds the highest clock (1MHz, 400kHz or 100kHz) where all devices on the bus pass GPIO_base::link_test(). 
+	 *	Clock is limited by 'max' and GPIO_base::max_clock() of the devices. 
+	 *	POLARITY registers are restored after the test. 
+	 *
+	 * @param bus		Bus ID
+	 * @param max		Maximum clock frequency in Hz
+	 * @param repeat	Number of test repeats at each clock
+	 * @return	Chosen clock frequency in Hz. 0 if the test failed even at 100kHz (clock is set to 100kHz)
+	 */
+	uint32_t	negotiate_clock( int bus, uint32_t max = 1000000, int repeat = 8 );
+
+	/** Fall back to next lower clock
+	 *
+	 *	Can be called when errors are found on the bus
+	 *
+	 * @param bus	Bus ID
+	 * @return	New clock frequency in Hz
+	 */
+	uint32_t	fallback( int bus );
+
+	/** I2C clock
+	 *
+	 * @param bus	Bus ID
+	 * @return	Clock frequency in Hz. 0 for SPI bus
+	 */
+	uint32_t	clock( int bus );
+
+	/** Submit a request
+	 *
+	 *	The request is copied into the queue of the bus which the device is on.
+	 *	Buffer pointed by 'data' should be kept until the completion.
+	 *
+	 * @param req	Request
+	 * @return	'true' if queued
+	 */
+	bool	submit( const BUS_REQUEST& req );
+
+	/** Submit a request
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param op		Request type
+	 * @param w			Accsess word
+	 * @param data		Pointer to data buffer
+	 * @param port		Port number for single port requests
+	 * @param callback	Completion callback. Can be 'NULL'
+	 * @return	'true' if queued
+	 */
+	bool	submit( GPIO_base& gpio, BUS_REQUEST::type op, access_word w, uint8_t* data, int port = 0, void (*callback)( BUS_REQUEST* ) = NULL );
+
+	/** Submit a request from ISR
+	 *
+	 *	The request is pushed into lock-free queue of the bus. 
+	 *	Only one ISR (producer) per bus is allowed. 
+	 *	Those requests are taken before requests by submit(). 
+	 *
+	 * @param req	Request
+	 * @return	'true' if queued
+	 */
+	bool	submit_from_isr( const BUS_REQUEST& req );
+
+	/** Bus lock
+	 *
+	 * @param bus	Bus ID
+	 * @return	Pointer to BUS_LOCK instance of the bus
+	 */
+	BUS_LOCK*	bus_lock( int bus );
+
+	/** Run one request on each bus
+	 *
+	 * @return	Number of executed requests
+	 */
+	int		run( void );
+
+	/** Run until all queues become empty
+	 *
+	 * @return	Number of executed requests
+	 */
+	int		run_all( void );
+
+	/** Run one request on a bus
+	 *
+	 * @param bus	Bus ID
+	 * @return	'true' if a request was executed
+	 */
+	bool	run_bus( int bus );
+
+	/** Number of pending requests
+	 *
+	 * @param bus	Bus ID
+	 * @return	Number of requests in the queue
+	 */
+	int		pending( int bus );
+
+	/** Number of buses
+	 *
+	 * @return	Number of buses
+	 */
+	int		buses( void );
+
+private:
+	struct bus_state {
+		TwoWire*		wire;
+		SPIClass*		spi;
+		uint32_t		clock;
+		BUS_REQUEST		queue[ QUEUE_LENGTH ];
+		int				n_queue;
+		BUS_LOCK		lock;
+		BUS_LOCK		queue_lock;
+		SPSC_QUEUE<BUS_REQUEST, QUEUE_LENGTH>	isr_queue;
+	};
+
+	struct device {
+		GPIO_base*		dev;
+		int				bus;
+		uint8_t			priority;
+	};
+
+	policy		pol;
+	bus_state	bus_list[ MAX_BUSES ];
+	int			n_buses;
+	device		dev_list[ MAX_DEVICES ];
+	int			n_devices;
+	int			next_bus;
+
+	device*		find( GPIO_base* gpio );
+	bool		take( int bus, BUS_REQUEST* rp );
+	void		set_clock( int bus, uint32_t clock );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_BUS_MANAGER_H
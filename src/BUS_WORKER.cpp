@@ -0,0 +1,303 @@
+#include "BUS_WORKER.h"
+
+#if defined( __linux__ ) && !defined( ARDUINO )
+
+#include <string.h>
+
+BUS_WORKER::BUS_WORKER()
+	: running( false ), sleeping( false ), n_submitted( 0 ), n_done( 0 )
+{
+	reset_statistics();
+}
+
+BUS_WORKER::~BUS_WORKER()
+{
+	stop();
+}
+
+void BUS_WORKER::start( void )
+{
+	if ( th.joinable() )
+		return;
+
+	running.store( true );
+	th	= std::thread( &BUS_WORKER::loop, this );
+}
+
+void BUS_WORKER::stop( void )
+{
+	if ( !th.joinable() )
+		return;
+
+	running.store( false );
+
+	{
+		std::lock_guard<std::mutex>	lk( mtx );
+		cv.notify_one();
+	}
+
+	th.join();
+}
+
+bool BUS_WORKER::submit( const BUS_REQUEST& req )
+{
+	item	i;
+
+	i.req	= req;
+	i.t		= clock::now();
+
+	if ( !queue.push( i ) ) {
+		n_rejected.fetch_add( 1, std::memory_order_relaxed );
+		return false;
+	}
+
+	n_submitted.fetch_add( 1 );
+
+	if ( sleeping.load() ) {
+		std::lock_guard<std::mutex>	lk( mtx );
+		cv.notify_one();
+	}
+
+	return true;
+}
+
+bool BUS_WORKER::submit( GPIO_base& gpio, BUS_REQUEST::type op, access_word w, uint8_t* data, int port, void (*callback)( BUS_REQUEST* ) )
+{
+	BUS_REQUEST	req;
+
+	req.dev			= &gpio;
+	req.op			= op;
+	req.w			= w;
+	req.port		= port;
+	req.priority	= 0;
+	req.data		= data;
+	req.callback	= callback;
+	req.user		= NULL;
+
+	return submit( req );
+}
+
+std::future<void> BUS_WORKER::submit_async( GPIO_base& gpio, BUS_REQUEST::type op, access_word w, uint8_t* data, int port )
+{
+	std::promise<void>*	pp	= new std::promise<void>;
+	std::future<void>	f	= pp->get_future();
+	BUS_REQUEST			req;
+
+	req.dev			= &gpio;
+	req.op			= op;
+	req.w			= w;
+	req.port		= port;
+	req.priority	= 0;
+	req.data		= data;
+	req.callback	= set_promise;
+	req.user		= pp;
+
+	if ( !submit( req ) ) {
+		delete pp;
+		return std::future<void>();
+	}
+
+	return f;
+}
+
+void BUS_WORKER::set_promise( BUS_REQUEST* rp )
+{
+	std::promise<void>*	pp	= (std::promise<void>*)rp->user;
+
+	pp->set_value();
+	delete pp;
+}
+
+void BUS_WORKER::flush( void )
+{
+	uint64_t	target	= n_submitted.load();
+
+	while ( n_done.load() < target )
+		std::this_thread::yield();
+}
+
+void BUS_WORKER::statistics( stats* sp )
+{
+	sp->requests	= n_requests.load( std::memory_order_relaxed );
+	sp->transfers	= n_transfers.load( std::memory_order_relaxed );
+	sp->rejected	= n_rejected.load( std::memory_order_relaxed );
+	sp->elapsed		= std::chrono::duration_cast<std::chrono::microseconds>( clock::now() - t_reset ).count();
+
+	for ( int i = 0; i < LATENCY_BINS; i++ )
+		sp->latency[ i ]	= hist[ i ].load( std::memory_order_relaxed );
+}
+
+void BUS_WORKER::reset_statistics( void )
+{
+	n_requests.store( 0 );
+	n_transfers.store( 0 );
+	n_rejected.store( 0 );
+
+	for ( int i = 0; i < LATENCY_BINS; i++ )
+		hist[ i ].store( 0 );
+
+	t_reset	= clock::now();
+}
+
+uint32_t BUS_WORKER::latency_percentile( double p )
+{
+	stats		s;
+	uint64_t	total	= 0;
+	uint64_t	sum		= 0;
+
+	statistics( &s );
+
+	for ( int i = 0; i < LATENCY_BINS; i++ )
+		total	+= s.latency[ i ];
+
+	for ( int i = 0; i < LATENCY_BINS; i++ ) {
+		sum	+= s.latency[ i ];
+
+		if ( total && (total * p <= sum * 100.0) )
+			return 1UL << i;
+	}
+
+	return 0;
+}
+
+double BUS_WORKER::throughput( void )
+{
+	stats	s;
+
+	statistics( &s );
+
+	return s.elapsed ? s.requests * 1000000.0 / s.elapsed : 0.0;
+}
+
+void BUS_WORKER::loop( void )
+{
+	item	batch[ MAX_COALESCE ];
+
+	for ( ; ; ) {
+		if ( !queue.peek() ) {
+			if ( !running.load() )
+				break;
+
+			for ( int i = 0; (i < 100) && !queue.peek(); i++ )
+				std::this_thread::yield();
+
+			if ( queue.peek() )
+				continue;
+
+			std::unique_lock<std::mutex>	lk( mtx );
+
+			sleeping.store( true );
+
+			if ( !queue.peek() && running.load() )
+				cv.wait_for( lk, std::chrono::milliseconds( 1 ) );
+
+			sleeping.store( false );
+			continue;
+		}
+
+		int		n	= 0;
+		int		lo	= 0;
+		int		hi	= 0;
+		item*	np;
+
+		queue.pop( &batch[ n++ ] );
+
+		BUS_REQUEST&	r		= batch[ 0 ].req;
+		int				length	= r.dev->field_length( r.w );
+
+		//	Only writes inside the register block are coalesced. A block larger than the image is not
+		if ( length <= MAX_IMAGE ) {
+			if ( BUS_REQUEST::WRITE_PORT == r.op ) {
+				hi	= length;
+			}
+			else if ( (BUS_REQUEST::WRITE_SINGLE == r.op) && (r.port < length) ) {
+				lo	= r.port;
+				hi	= r.port + 1;
+			}
+		}
+
+		while ( (lo < hi) && (n < MAX_COALESCE) && (NULL != (np = queue.peek())) && mergeable( batch[ 0 ], *np, lo, hi, length ) ) {
+			if ( BUS_REQUEST::WRITE_PORT == np->req.op ) {
+				lo	= 0;
+				hi	= length;
+			}
+			else {
+				lo	= (np->req.port < lo) ? np->req.port : lo;
+				hi	= (hi <= np->req.port) ? np->req.port + 1 : hi;
+			}
+
+			queue.pop( &batch[ n++ ] );
+		}
+
+		issue( batch, n );
+	}
+}
+
+bool BUS_WORKER::mergeable( const item& first, const item& next, int lo, int hi, int length )
+{
+	if ( (next.req.dev != first.req.dev) || (next.req.w != first.req.w) )
+		return false;
+
+	if ( BUS_REQUEST::WRITE_PORT == next.req.op )
+		return true;
+
+	//	Adjacent or overlapping port, inside the register block
+	if ( BUS_REQUEST::WRITE_SINGLE == next.req.op )
+		return (lo - 1 <= next.req.port) && (next.req.port <= hi) && (next.req.port < length);
+
+	return false;
+}
+
+void BUS_WORKER::issue( item* items, int n )
+{
+	BUS_REQUEST	r	= items[ 0 ].req;
+
+	if ( 1 == n ) {
+		r.callback	= NULL;
+		r.execute();
+	}
+	else {
+		uint8_t	image[ MAX_IMAGE ];
+		int		length	= r.dev->field_length( r.w );
+		int		lo		= length;
+		int		hi		= 0;
+
+		for ( int i = 0; i < n; i++ ) {
+			BUS_REQUEST&	q	= items[ i ].req;
+
+			if ( BUS_REQUEST::WRITE_PORT == q.op ) {
+				memcpy( image, q.data, length );
+				lo	= 0;
+				hi	= length;
+			}
+			else {
+				image[ q.port ]	= q.data[ 0 ];
+				lo	= (q.port < lo) ? q.port : lo;
+				hi	= (hi <= q.port) ? q.port + 1 : hi;
+			}
+		}
+
+		r.dev->write_port( r.w, image + lo, lo, hi - lo );
+	}
+
+	n_transfers.fetch_add( 1, std::memory_order_relaxed );
+
+	for ( int i = 0; i < n; i++ )
+		complete( items + i );
+}
+
+void BUS_WORKER::complete( item* ip )
+{
+	uint64_t	us	= std::chrono::duration_cast<std::chrono::microseconds>( clock::now() - ip->t ).count();
+	int			bin	= us ? 64 - __builtin_clzll( us ) : 0;
+
+	hist[ (LATENCY_BINS <= bin) ? LATENCY_BINS - 1 : bin ].fetch_add( 1, std::memory_order_relaxed );
+	n_requests.fetch_add( 1, std::memory_order_relaxed );
+
+	if ( ip->req.callback )
+		ip->req.callback( &ip->req );
+
+	n_done.fetch_add( 1 );
+}
+
+#endif	//	__linux__ && !ARDUINO
@@ -0,0 +1,169 @@
+/** BUS_WORKER: per-bus I/O worker thread for GPIO operation library, Linux host
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_BUS_WORKER_H
+#define ARDUINO_GPIO_NXP_ARD_BUS_WORKER_H
+
+#if defined( __linux__ ) && !defined( ARDUINO )
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <BUS_MANAGER.h>
+#include <MPSC_QUEUE.h>
+
+/** BUS_WORKER class
+ *	
+ *  @class BUS_WORKER
+ *
+ *	I/O worker thread for a bus on Linux host. 
+ *	Application threads submit BUS_REQUESTs into a lock-free MPSC queue and 
+ *	the worker issues them in order, so blocking ioctls are done only on the worker thread. 
+ *	One instance should be used per bus (per transport). 
+ *
+ *	Adjacent write requests to same device and access_word are coalesced: 
+ *	a later write to same port overrides earlier one and writes to neighboring ports 
+ *	are merged into one burst inside the register block. Reads are never reordered. 
+ *	Completion is notified by callback on worker thread or by std::future. 
+ *
+ *	Submit-to-completion latency is recorded in a histogram of power-of-2 microseconds bins. 
+ */
+class BUS_WORKER {
+public:
+	/** Number of requests can be queued */
+	static constexpr int	QUEUE_LENGTH	= 256;
+
+	/** Maximum number of requests coalesced into one transfer */
+	static constexpr int	MAX_COALESCE	= 16;
+
+	/** Number of latency histogram bins */
+	static constexpr int	LATENCY_BINS	= 32;
+
+	/** Statistics */
+	struct stats {
+		uint64_t	requests;		/**< Completed requests */
+		uint64_t	transfers;		/**< Issued transfers */
+		uint64_t	rejected;		/**< Requests rejected by full queue */
+		uint64_t	elapsed;		/**< Time since reset in microseconds */
+		uint32_t	latency[ LATENCY_BINS ];	/**< Histogram. Bin 'n' counts latency < 2^n microseconds */
+	};
+
+	/** Constractor */
+	BUS_WORKER();
+
+	/** Destractor. Worker is stopped after all queued requests are done */
+	~BUS_WORKER();
+
+	/** Start worker thread */
+	void	start( void );
+
+	/** Stop worker thread
+	 *
+	 *	Queued requests are done before stop
+	 */
+	void	stop( void );
+
+	/** Submit a request
+	 *
+	 *	Can be called from any thread. 
+	 *	Buffer pointed by 'data' should be kept until the completion.
+	 *	'callback' is called on worker thread.
+	 *
+	 * @param req	Request
+	 * @return	'true' if queued
+	 */
+	bool	submit( const BUS_REQUEST& req );
+
+	/** Submit a request
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param op		Request type
+	 * @param w			Accsess word
+	 * @param data		Pointer to data buffer
+	 * @param port		Port number for single port requests
+	 * @param callback	Completion callback. Can be 'NULL'
+	 * @return	'true' if queued
+	 */
+	bool	submit( GPIO_base& gpio, BUS_REQUEST::type op, access_word w, uint8_t* data, int port = 0, void (*callback)( BUS_REQUEST* ) = NULL );
+
+	/** Submit a request and get a future
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param op		Request type
+	 * @param w			Accsess word
+	 * @param data		Pointer to data buffer
+	 * @param port		Port number for single port requests
+	 * @return	Future which becomes ready at completion. Not valid() if the queue is full
+	 */
+	std::future<void>	submit_async( GPIO_base& gpio, BUS_REQUEST::type op, access_word w, uint8_t* data, int port = 0 );
+
+	/** Wait until all submitted requests are done */
+	void	flush( void );
+
+	/** Get statistics
+	 *
+	 * @param sp	Pointer to stats
+	 */
+	void	statistics( stats* sp );
+
+	/** Reset statistics */
+	void	reset_statistics( void );
+
+	/** Latency percentile
+	 *
+	 * @param p	Percentile. 0.0 ~ 100.0
+	 * @return	Upper bound of latency in microseconds
+	 */
+	uint32_t	latency_percentile( double p );
+
+	/** Throughput
+	 *
+	 * @return	Completed requests per second since reset
+	 */
+	double	throughput( void );
+
+private:
+	typedef std::chrono::steady_clock	clock;
+
+	/** Maximum length of a register block for coalescing */
+	static constexpr int	MAX_IMAGE	= 16;
+
+	struct item {
+		BUS_REQUEST			req;
+		clock::time_point	t;
+	};
+
+	MPSC_QUEUE<item, QUEUE_LENGTH>	queue;
+	std::thread						th;
+	std::atomic<bool>				running;
+	std::atomic<bool>				sleeping;
+	std::mutex						mtx;
+	std::condition_variable			cv;
+
+	std::atomic<uint64_t>			n_submitted;
+	std::atomic<uint64_t>			n_done;
+	std::atomic<uint64_t>			n_requests;
+	std::atomic<uint64_t>			n_transfers;
+	std::atomic<uint64_t>			n_rejected;
+	std::atomic<uint32_t>			hist[ LATENCY_BINS ];
+	clock::time_point				t_reset;
+
+	void	loop( void );
+	bool	mergeable( const item& first, const item& next, int lo, int hi, int length );
+	void	issue( item* items, int n );
+	void	complete( item* ip );
+
+	static void	set_promise( BUS_REQUEST* rp );
+};
+
+#endif	//	__linux__ && !ARDUINO
+
+#endif //	ARDUINO_GPIO_NXP_ARD_BUS_WORKER_H
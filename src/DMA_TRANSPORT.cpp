@@ -0,0 +1,202 @@
+#include "DMA_TRANSPORT.h"
+
+#include <string.h>
+
+#if defined( ARDUINO )
+#include <Arduino.h>
+#else
+#include <thread>
+#endif
+
+DMA_TRANSPORT::DMA_TRANSPORT( DMA_ENGINE& engine, GPIO_TRANSPORT* polled, uint16_t threshold )
+	: dma( engine ), poll( polled ), thr( threshold ), pending( false ), last_result( 0 ), n_dma( 0 ),
+	deferred( false ), w_failed( false ), w_address( 0 ), w_reg( 0 ), w_size( 0 ), cb( NULL ), cb_arg( NULL )
+{
+	dma.handler( on_complete, this );
+}
+
+DMA_TRANSPORT::~DMA_TRANSPORT()
+{
+	wait();
+	dma.handler( NULL, NULL );
+}
+
+int DMA_TRANSPORT::reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+{
+	if ( settle( address ) < 0 )
+		return -1;
+
+	if ( !use_dma( size ) )
+		return poll ? poll->reg_w( address, reg, data, size ) : NOT_HANDLED;
+
+	//	Buffer is still kept by a failed write to other device
+	bool	buffered	= (size <= BUFFER_SIZE) && !deferred;
+
+	if ( buffered ) {
+		memcpy( buf, data, size );
+		w_address	= address;
+		w_reg		= reg;
+		w_size		= size;
+	}
+
+	__atomic_store_n( &pending, true, __ATOMIC_RELEASE );
+
+	if ( !dma.start_write( address, reg, buffered ? buf : data, size ) ) {
+		__atomic_store_n( &pending, false, __ATOMIC_RELEASE );
+		return poll ? poll->reg_w( address, reg, data, size ) : NOT_HANDLED;
+	}
+
+	n_dma++;
+
+	if ( !buffered )
+		return wait();
+
+	deferred	= true;
+
+	return size;
+}
+
+int DMA_TRANSPORT::reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+{
+	if ( settle( address ) < 0 )
+		return -1;
+
+	if ( !use_dma( size ) )
+		return poll ? poll->reg_r( address, reg, data, size ) : NOT_HANDLED;
+
+	__atomic_store_n( &pending, true, __ATOMIC_RELEASE );
+
+	if ( !dma.start_read( address, reg, data, size ) ) {
+		__atomic_store_n( &pending, false, __ATOMIC_RELEASE );
+		return poll ? poll->reg_r( address, reg, data, size ) : NOT_HANDLED;
+	}
+
+	n_dma++;
+
+	return wait();
+}
+
+int DMA_TRANSPORT::txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+{
+	if ( settle( NONE ) < 0 )
+		return -1;
+
+	if ( !use_dma( size ) )
+		return poll ? poll->txrx( w_data, r_data, size ) : NOT_HANDLED;
+
+	__atomic_store_n( &pending, true, __ATOMIC_RELEASE );
+
+	if ( !dma.start_txrx( w_data, r_data, size ) ) {
+		__atomic_store_n( &pending, false, __ATOMIC_RELEASE );
+		return poll ? poll->txrx( w_data, r_data, size ) : NOT_HANDLED;
+	}
+
+	n_dma++;
+
+	return wait();
+}
+
+int DMA_TRANSPORT::txrx_sequence( const uint8_t* w_data, uint8_t* r_data, const uint16_t* sizes, int n )
+{
+	if ( poll )
+		return GPIO_TRANSPORT::txrx_sequence( w_data, r_data, sizes, n );
+
+	return (settle( NONE ) < 0) ? -1 : NOT_HANDLED;
+}
+
+void DMA_TRANSPORT::threshold( uint16_t size )
+{
+	thr	= size;
+}
+
+void DMA_TRANSPORT::callback( void (*func)( void* arg, int result ), void* arg )
+{
+	cb		= func;
+	cb_arg	= arg;
+}
+
+bool DMA_TRANSPORT::busy( void )
+{
+	return __atomic_load_n( &pending, __ATOMIC_ACQUIRE );
+}
+
+int DMA_TRANSPORT::wait( void )
+{
+	while ( busy() ) {
+#if defined( ARDUINO )
+		yield();
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+	return last_result;
+}
+
+int DMA_TRANSPORT::sync( void )
+{
+	return settle( ANY );
+}
+
+uint32_t DMA_TRANSPORT::dma_count( void )
+{
+	return n_dma;
+}
+
+bool DMA_TRANSPORT::use_dma( uint16_t size )
+{
+	return thr <= size;
+}
+
+int DMA_TRANSPORT::settle( int address )
+{
+	int	r	= wait();
+
+	if ( !deferred )
+		return 0;
+
+	if ( !w_failed ) {
+		if ( 0 <= r ) {
+			deferred	= false;
+			return 0;
+		}
+
+		w_failed	= true;
+	}
+
+	//	Write without waiting has failed. 
+	//	It is kept until next access to its target, so the failure is reported to that device
+	if ( (ANY != address) && (w_address != address) )
+		return 0;
+
+	__atomic_store_n( &pending, true, __ATOMIC_RELEASE );
+
+	if ( !dma.start_write( w_address, w_reg, buf, w_size ) ) {
+		__atomic_store_n( &pending, false, __ATOMIC_RELEASE );
+		last_result	= poll ? poll->reg_w( w_address, w_reg, buf, w_size ) : -1;
+	}
+	else {
+		n_dma++;
+		wait();
+	}
+
+	if ( last_result < 0 )
+		return -1;
+
+	deferred	= false;
+	w_failed	= false;
+
+	return 0;
+}
+
+void DMA_TRANSPORT::on_complete( void* arg, int result )
+{
+	DMA_TRANSPORT*	tp	= (DMA_TRANSPORT*)arg;
+
+	tp->last_result	= result;
+
+	if ( tp->cb )
+		tp->cb( tp->cb_arg, result );
+
+	__atomic_store_n( &tp->pending, false, __ATOMIC_RELEASE );
+}
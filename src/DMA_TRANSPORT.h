@@ -0,0 +1,199 @@
+/** DMA_TRANSPORT: DMA-backed burst transport for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_DMA_TRANSPORT_H
+#define ARDUINO_GPIO_NXP_ARD_DMA_TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "GPIO_TRANSPORT.h"
+
+/** DMA_ENGINE class
+ *	
+ *  @class DMA_ENGINE
+ *
+ *	Interface to a platform DMA controller driving an I2C or SPI peripheral. 
+ *	start_*() starts a transfer and returns immediately. 
+ *	The engine should call complete() when the transfer is finished (typically from DMA ISR). 
+ */
+class DMA_ENGINE {
+public:
+	DMA_ENGINE() : fp( NULL ), user( NULL ) {}
+	virtual ~DMA_ENGINE() {}
+
+	/** Start register write
+	 * 
+	 * @param address	Target address
+	 * @param reg		Register address (with auto-increment flag if needed)
+	 * @param data		Pointer to data. Should be kept until completion
+	 * @param size		Data size
+	 * @return	'false' if the transfer cannot be started
+	 */
+	virtual bool	start_write( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )	= 0;
+
+	/** Start register read
+	 * 
+	 * @param address	Target address
+	 * @param reg		Register address (with auto-increment flag if needed)
+	 * @param data		Pointer to data buffer
+	 * @param size		Data size
+	 * @return	'false' if the transfer cannot be started
+	 */
+	virtual bool	start_read( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )	= 0;
+
+	/** Start full-duplex transfer (for SPI)
+	 * 
+	 * @param w_data	Pointer to data to be sent. Should be kept until completion
+	 * @param r_data	Pointer to buffer for received data
+	 * @param size		Data size
+	 * @return	'false' if the transfer cannot be started
+	 */
+	virtual bool	start_txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+	{
+		(void)w_data;
+		(void)r_data;
+		(void)size;
+		return false;
+	}
+
+	/** Set completion handler
+	 * 
+	 * @param func		Function called at completion with 'arg' and result (transferred size or negative value for error)
+	 * @param arg		Argument for the function
+	 */
+	void	handler( void (*func)( void* arg, int result ), void* arg )
+	{
+		fp		= func;
+		user	= arg;
+	}
+
+protected:
+	/** Notify completion. Should be called by the engine
+	 * 
+	 * @param result	Transferred data size. Negative value for error
+	 */
+	void	complete( int result )
+	{
+		if ( fp )
+			fp( user, result );
+	}
+
+private:
+	void	(*fp)( void* arg, int result );
+	void*	user;
+};
+
+/** DMA_TRANSPORT class
+ *	
+ *  @class DMA_TRANSPORT
+ *
+ *	Transport which does bursts at or above a threshold by DMA_ENGINE. 
+ *	Smaller accesses go to 'polled' transport, or to the device's default path 
+ *	(I2C_device/Wire or GPIO_SPI/SPIClass) if it is not given. 
+ *	Set it to a device by GPIO_base::transport(). Device API is not changed. 
+ *
+ *	A burst write up to BUFFER_SIZE is copied and returns without waiting for its completion. 
+ *	Next access waits for it. Reads wait for the completion. 
+ *	If the write without waiting has failed, it is kept for its target address. 
+ *	Next access to the same address does the write again before its own transfer 
+ *	and returns an error if it fails again. So the failure is seen in GPIO_base::last_status() 
+ *	of the next access to the device and covered by its retries. 
+ *	Accesses to other addresses are not affected. sync() reports it without a device access. 
+ */
+class DMA_TRANSPORT : public GPIO_TRANSPORT {
+public:
+	/** Size of buffer for write without waiting */
+	static constexpr int	BUFFER_SIZE	= 64;
+
+	/** Constractor
+	 * 
+	 * @param engine	DMA engine
+	 * @param polled	Transport for small accesses. If NULL, those are done by device's default path
+	 * @param threshold	Bursts of this size or larger are done by DMA
+	 */
+	DMA_TRANSPORT( DMA_ENGINE& engine, GPIO_TRANSPORT* polled = NULL, uint16_t threshold = 8 );
+
+	virtual ~DMA_TRANSPORT();
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size );
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size );
+	virtual int	txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size );
+
+	/** Sequence of full-duplex frames (for SPI)
+	 *
+	 *	Frames are done one by one by txrx() if 'polled' transport is given. 
+	 *	Otherwise, the sequence is left to device's default path (one SPI transaction)
+	 */
+	virtual int	txrx_sequence( const uint8_t* w_data, uint8_t* r_data, const uint16_t* sizes, int n );
+
+	/** Set threshold
+	 * 
+	 * @param size	Bursts of this size or larger are done by DMA
+	 */
+	void		threshold( uint16_t size );
+
+	/** Set completion callback
+	 * 
+	 *	Called at completion of each DMA transfer, on the context where the engine notifies (can be ISR)
+	 *
+	 * @param func	Callback function. NULL to disable
+	 * @param arg	Argument for the function
+	 */
+	void		callback( void (*func)( void* arg, int result ), void* arg = NULL );
+
+	/** Check DMA transfer in progress
+	 * 
+	 * @return	'true' if busy
+	 */
+	bool		busy( void );
+
+	/** Wait for completion of DMA transfer
+	 * 
+	 * @return	Result of last DMA transfer. Transferred data size or negative value for error
+	 */
+	int			wait( void );
+
+	/** Finish write without waiting
+	 * 
+	 *	Waits for completion. If the write has failed, it is done again. 
+	 *
+	 * @return	0 if no write is left failed. Negative value if it has failed again
+	 */
+	int			sync( void );
+
+	/** Number of DMA transfers
+	 * 
+	 * @return	Number of transfers done by DMA
+	 */
+	uint32_t	dma_count( void );
+
+private:
+	DMA_ENGINE&		dma;
+	GPIO_TRANSPORT*	poll;
+	uint16_t		thr;
+	bool			pending;
+	int				last_result;
+	uint32_t		n_dma;
+	bool			deferred;
+	bool			w_failed;
+	uint8_t			w_address;
+	uint8_t			w_reg;
+	uint16_t		w_size;
+	uint8_t			buf[ BUFFER_SIZE ];
+	void			(*cb)( void* arg, int result );
+	void*			cb_arg;
+
+	bool		use_dma( uint16_t size );
+	static constexpr int	NONE	= -1;
+	static constexpr int	ANY		= 0x100;
+
+	int			settle( int address );
+	static void	on_complete( void* arg, int result );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_DMA_TRANSPORT_H
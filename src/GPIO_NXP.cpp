@@ -1,4 +1,5 @@
 #include	"GPIO_NXP.h"
+#include	"BIT_OPS.h"
 
 /* ******** GPIO_base ******** */
 
@@ -7,9 +8,22 @@ GPIO_base::GPIO_base( uint8_t i2c_address, int nbits, const uint8_t* ar, uint8_t
 	n_bits( nbits ),
 	n_ports( (nbits + 7) / 8 ),
 	auto_increment( ai ),
-	arp( ar )
+	arp( ar ),
+	lockp( NULL ),
+	transportp( NULL ),
+	swap16( false ),
+	wirep( &Wire ),
+	max_retries( 0 ),
+	backoff_us( 100 ),
+	deadline_us( 0 ),
+	sda( -1 ),
+	scl( -1 ),
+	recovery_clock( 0 ),
+	status( XFER_OK ),
+	elapsed_us( 0 ),
+	n_retries( 0 ),
+	depth( 0 )
 {
-	init();
 }
 
 GPIO_base::GPIO_base( TwoWire& wire, uint8_t i2c_address, int nbits, const uint8_t* ar, uint8_t ai  ) :
@@ -17,17 +31,22 @@ GPIO_base::GPIO_base( TwoWire& wire, uint8_t i2c_address, int nbits, const uint8
 	n_bits( nbits ),
 	n_ports( (nbits + 7) / 8 ),
 	auto_increment( ai ),
-	arp( ar )
+	arp( ar ),
+	lockp( NULL ),
+	transportp( NULL ),
+	swap16( false ),
+	wirep( &wire ),
+	max_retries( 0 ),
+	backoff_us( 100 ),
+	deadline_us( 0 ),
+	sda( -1 ),
+	scl( -1 ),
+	recovery_clock( 0 ),
+	status( XFER_OK ),
+	elapsed_us( 0 ),
+	n_retries( 0 ),
+	depth( 0 )
 {
-	init();
-}
-
-void GPIO_base::init( void )
-{
-	constexpr uint16_t	i	= 0x0001;
-	uint8_t*			tp	= (uint8_t*)(&i);
-
-	endian	= tp[ 0 ];	//	'true' if LittleEndian
 }
 
 GPIO_base::~GPIO_base()
@@ -54,6 +73,8 @@ void GPIO_base::begin( board env )
 
 void GPIO_base::output( int port, uint8_t value, uint8_t mask )
 {
+	scope	sc( this );
+
 	if ( mask )
 		bit_op8( *(arp + OUT) + port, mask, value );
 
@@ -67,6 +88,8 @@ void GPIO_base::output( const uint8_t *vp )
 
 uint8_t GPIO_base::input( int port )
 {
+	scope	sc( this );
+
 	return read_r8( *(arp + IN) + port );
 }
 
@@ -79,6 +102,8 @@ uint8_t* GPIO_base::input( uint8_t *vp )
 
 void GPIO_base::config( int port, uint8_t config, uint8_t mask )
 {
+	scope	sc( this );
+
 	if ( mask )
 		bit_op8( *(arp + CONFIG) + port, mask, config );
 
@@ -92,97 +117,614 @@ void GPIO_base::config( const uint8_t* vp )
 
 void GPIO_base::write_port( access_word w, const uint8_t* vp )
 {
-	if ( auto_increment ) {
-		reg_w( auto_increment | *(arp + w), vp, n_ports );		
-	}
-	else {
-		for ( int i = 0; i < n_ports; i++ )
-			write_r8( *(arp + w) + i, *vp++ );
-	}
+	write_field( w, vp );
+}
+
+void GPIO_base::write_port( access_word w, const uint8_t* vp, int port_num, int length )
+{
+	write_field( w, vp, port_num, length );
 }
 
 void GPIO_base::write_port16( access_word w, const uint16_t* vp )
 {
-	uint16_t	b[ n_ports ];
+	scope	sc( this );
+
+	//	Register 'A' (lower pins) is in upper byte of the 16 bit value. 
+	//	On little endian host, bytes of each element are swapped where the frame is built, without copy here
+	swap16	= GPIO_NXP_LITTLE_ENDIAN;
+	write_field( w, (const uint8_t*)vp );
+	swap16	= false;
+}
+
+uint8_t* GPIO_base::read_port( access_word w, uint8_t* vp )
+{
+	read_field( w, vp );
 	
-	if ( endian ) {
-		uint16_t	temp;
-		for ( int i = 0; i < n_ports; i++ ) {
-			temp	= vp[ i ] << 8;
-			b[ i ]	= temp | vp[ i ] >> 8;			
-		}
-	}
-	else {
-		memcpy( b, vp, n_ports << 1 );
-	}
+	return vp;
+}
+
+uint16_t*  GPIO_base::read_port16( access_word w, uint16_t* vp )
+{
+	int			n_bytes	= field_length( w );
+	uint8_t*	bp		= (uint8_t*)vp;
+
+	//	Read into caller's buffer and convert in place. 
+	//	Each 16 bit element is made from the 2 bytes it occupies
+	if ( n_bytes & 0x1 )
+		bp[ n_bytes ]	= 0;
+
+	read_field( w, bp );
+
+	for ( int i = 0; i < (n_bytes + 1) / 2; i++ )
+		vp[ i ]	= (bp[ i * 2 ] << 8) | bp[ i * 2 + 1 ];
 	
-	int	n_bytes	= (n_bits * 2 + 7) / 8;
+	return vp;
+}
+
+void GPIO_base::write_port( access_word w, uint8_t value, int port_num )
+{
+	scope	sc( this );
+
+	write_r8( *(arp + w) + port_num, value );
+}
+
+void GPIO_base::write_port16( access_word w, uint16_t value, int port_num )
+{
+	uint8_t	b[ 2 ]		= { (uint8_t)(value >> 8), (uint8_t)value };
+	int		length		= field_length( w ) - port_num;
+
+	//	Port out of the block
+	if ( (port_num < 0) || (length <= 0) )
+		return;
+
+	write_field( w, b, port_num, (2 < length) ? 2 : length );
+}
+
+void GPIO_base::write_pair16( access_word w, uint16_t value, int pair )
+{
+	write_port16( w, value, pair * 2 );
+}
+
+uint8_t GPIO_base::read_port( access_word w, int port_num )
+{
+	scope	sc( this );
+
+	return read_r8( *(arp + w) + port_num );
+}
+
+uint16_t GPIO_base::read_port16( access_word w, int port_num )
+{
+	uint8_t	b[ 2 ]		= { 0, 0 };
+	int		length		= field_length( w ) - port_num;
+
+	//	Port out of the block
+	if ( (port_num < 0) || (length <= 0) )
+		return 0;
+
+	read_field( w, b, port_num, (2 < length) ? 2 : length );
+
+	return (b[ 0 ] << 8) | b[ 1 ];
+}
+
+uint16_t GPIO_base::read_pair16( access_word w, int pair )
+{
+	return read_port16( w, pair * 2 );
+}
+
+int GPIO_base::field_length( access_word w )
+{
+	int	bits_per_pin	= ((DRIVE_STRENGTH == w) || (INT_EDGE == w)) ? 2 : 1;
+
+	return (n_bits * bits_per_pin + 7) / 8;
+}
+
+void GPIO_base::write_field( access_word w, const uint8_t* vp, int offset, int length )
+{
+	scope	sc( this );
+
+	uint8_t	reg	= *(arp + w) + offset;
+
+	if ( length < 0 )
+		length	= field_length( w ) - offset;
+
+	if ( length <= 0 )
+		return;
 
 	if ( auto_increment ) {
-		reg_w( auto_increment | *(arp + w), (uint8_t*)b, n_bytes );		
+		reg_w( auto_increment | reg, vp, length );		
 	}
 	else {
-		for ( int i = 0; i < n_bytes; i++ )
-			write_r8( *(arp + w) + i, b[ i ] );
+		for ( int i = 0; i < length; i++ )
+			write_r8( reg + i, vp[ swap16 ? i ^ 1 : i ] );
 	}
 }
 
-uint8_t* GPIO_base::read_port( access_word w, uint8_t* vp )
+void GPIO_base::read_field( access_word w, uint8_t* vp, int offset, int length )
 {
+	scope	sc( this );
+
+	uint8_t	reg	= *(arp + w) + offset;
+
+	if ( length < 0 )
+		length	= field_length( w ) - offset;
+
+	if ( length <= 0 )
+		return;
+
 	if ( auto_increment ) {
-		reg_r( auto_increment | *(arp + w), vp, n_ports );		
+		reg_r( auto_increment | reg, vp, length );		
 	}
 	else {
-		for ( int i = 0; i < n_ports; i++ )
-			*(vp + i)	= read_r8( *(arp + w) + i );
+		for ( int i = 0; i < length; i++ )
+			*vp++	= read_r8( reg + i );
 	}
-	
-	return vp;
 }
 
-uint16_t*  GPIO_base::read_port16( access_word w, uint16_t* vp )
+void GPIO_base::write_stream( access_word w, const uint8_t* vp, int length, int port_num )
 {
-	int	n_bytes	= (n_bits * 2 + 7) / 8;
-	
-	if ( auto_increment ) {
-		reg_r( auto_increment | *(arp + w), (uint8_t*)vp, n_bytes );	
+	scope	sc( this );
+
+	if ( 2 != n_ports ) {
+		reg_w( *(arp + w) + port_num, vp, length );
 	}
 	else {
-		for ( int i = 0; i < n_bytes; i++ )
-			*(vp + i)	= read_r8( *(arp + w) + i );		
+		for ( int i = 0; i < length; i++ )
+			write_r8( *(arp + w) + port_num, *vp++ );
 	}
-		
+}
+
+void GPIO_base::write_pin2( access_word w, uint64_t pins, uint8_t value )
+{
+	scope	sc( this );
+
+	int			n_bytes	= field_length( w );
+	uint64_t	spread[ 2 ]	= {
+		BIT_OPS::interleave( (uint32_t)pins ),
+		BIT_OPS::interleave( (uint32_t)(pins >> 32) ),
+	};
+	uint8_t		cur[ n_bytes ];
+	uint8_t		b[ n_bytes ];
+	int			first	= n_bytes;
+	int			last	= -1;
 
-	if ( endian ) {
-		uint16_t	temp;
+	read_field( w, cur );
 
-		for ( int i = 0; i < n_ports; i++ ) {
-			temp	= vp[ i ] << 8;
-			vp[ i ]	= temp | vp[ i ] >> 8;			
+	for ( int i = 0; i < n_bytes; i++ ) {
+		uint8_t	s	= spread[ i >> 3 ] >> ((i & 7) * 8);
+
+		b[ i ]	= (cur[ i ] & ~(s * 3)) | (s * (value & 0x3));
+
+		if ( b[ i ] != cur[ i ] ) {
+			first	= (i < first) ? i : first;
+			last	= i;
 		}
 	}
-	
+
+	if ( first <= last )
+		write_field( w, b + first, first, last - first + 1 );
+}
+
+uint64_t GPIO_base::read_pin2( access_word w, uint8_t value )
+{
+	scope	sc( this );
+
+	int			n_bytes		= field_length( w );
+	uint8_t		b[ n_bytes ];
+	uint64_t	image[ 2 ]	= { 0, 0 };
+
+	read_field( w, b );
+
+	for ( int i = n_bytes - 1; 0 <= i; i-- )
+		image[ i >> 3 ]	= (image[ i >> 3 ] << 8) | b[ i ];
+
+	uint64_t	p0	= BIT_OPS::deinterleave( image[ 0 ] )      | (uint64_t)BIT_OPS::deinterleave( image[ 1 ] ) << 32;
+	uint64_t	p1	= BIT_OPS::deinterleave( image[ 0 ] >> 1 ) | (uint64_t)BIT_OPS::deinterleave( image[ 1 ] >> 1 ) << 32;
+	uint64_t	all	= (n_bits < 64) ? (1ULL << n_bits) - 1 : ~0ULL;
+
+	return ((value & 0x1) ? p0 : ~p0) & ((value & 0x2) ? p1 : ~p1) & all;
+}
+
+void GPIO_base::drive_strength( uint64_t pins, uint8_t level )
+{
+	write_pin2( DRIVE_STRENGTH, pins, level );
+}
+
+void GPIO_base::interrupt_edge( uint64_t pins, edge e )
+{
+	write_pin2( INT_EDGE, pins, e );
+}
+
+void GPIO_base::bus_lock( BUS_LOCK* lock )
+{
+	lockp	= lock;
+}
+
+BUS_LOCK* GPIO_base::bus_lock( void )
+{
+	return lockp;
+}
+
+void GPIO_base::transport( GPIO_TRANSPORT* tp )
+{
+	transportp	= tp;
+}
+
+GPIO_TRANSPORT* GPIO_base::transport( void )
+{
+	return transportp;
+}
+
+TwoWire* GPIO_base::wire( void )
+{
+	return wirep;
+}
+
+SPIClass* GPIO_base::spi( void )
+{
+	return NULL;
+}
+
+int GPIO_base::reg_w( uint8_t reg_adr, const uint8_t *data, uint16_t size )
+{
+	return transaction( true, reg_adr, (uint8_t*)data, size );
+}
+
+int GPIO_base::reg_w( uint8_t reg_adr, uint8_t data )
+{
+	return transaction( true, reg_adr, &data, 1 );
+}
+
+int GPIO_base::reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size )
+{
+	return transaction( false, reg_adr, data, size );
+}
+
+uint8_t GPIO_base::reg_r( uint8_t reg_adr )
+{
+	uint8_t	data	= 0;
+
+	transaction( false, reg_adr, &data, 1 );
+
+	return data;
+}
+
+void GPIO_base::bit_op8( uint8_t reg, uint8_t mask, uint8_t value )
+{
+	scope	sc( this );
+
+	I2C_device::bit_op8( reg, mask, value );
+}
+
+void GPIO_base::bit_op16( uint8_t reg, uint16_t mask, uint16_t value )
+{
+	scope	sc( this );
+
+	I2C_device::bit_op16( reg, mask, value );
+}
+
+int GPIO_base::transaction( bool write, uint8_t reg_adr, uint8_t* data, uint16_t size )
+{
+	uint32_t	start	= micros();
+	uint32_t	wait	= backoff_us;
+	uint32_t	elapsed;
+	int			retries	= 0;
+	xfer_status	st;
+	int			r;
+
+	//	Access out of a method scope (like write_r8() called by user) is a call by itself
+	if ( !depth ) {
+		status		= XFER_OK;
+		elapsed_us	= 0;
+		n_retries	= 0;
+	}
+
+	for ( ; ; ) {
+		r		= write ? raw_w( reg_adr, data, size ) : raw_r( reg_adr, data, size );
+		elapsed	= micros() - start;
+
+		if ( 0 <= r ) {
+			st	= XFER_OK;
+			break;
+		}
+
+		if ( max_retries <= retries ) {
+			st	= XFER_ERROR;
+			break;
+		}
+
+		if ( deadline_us && (deadline_us <= elapsed + wait) ) {
+			st	= XFER_TIMEOUT;
+			break;
+		}
+
+		if ( (0 <= scl) && !transportp )
+			bus_recovery();
+
+		if ( 1000 <= wait )
+			delay( wait / 1000 );
+		else
+			delayMicroseconds( wait );
+
+		wait	*= 2;
+		retries++;
+	}
+
+	//	First error in a method call is kept
+	if ( XFER_OK == status )
+		status	= st;
+
+	elapsed_us	+= micros() - start;
+	n_retries	+= retries;
+
+	return r;
+}
+
+int GPIO_base::raw_w( uint8_t reg_adr, const uint8_t* data, uint16_t size )
+{
+	if ( transportp ) {
+		int	r;
+
+		if ( swap16 ) {
+			//	Transport takes a contiguous frame: swapped bytes are made here
+			uint8_t	b[ size ];
+
+			for ( int i = 0; i < size; i++ )
+				b[ i ]	= data[ i ^ 1 ];
+
+			r	= transportp->reg_w( i2c_addr, reg_adr, b, size );
+		}
+		else {
+			r	= transportp->reg_w( i2c_addr, reg_adr, data, size );
+		}
+
+		if ( GPIO_TRANSPORT::NOT_HANDLED != r )
+			return r;
+	}
+
+	//	One byte of Wire buffer is used for register address. Swapped chunks keep byte pairs
+	const int	chunk	= swap16 ? (GPIO_NXP_WIRE_BUFFER - 1) & ~0x1 : GPIO_NXP_WIRE_BUFFER - 1;
+	bool		ai		= auto_increment && (reg_adr & auto_increment);
+
+	for ( int done = 0; done < size; done += chunk ) {
+		int	n	= (chunk < size - done) ? chunk : size - done;
+		int	r;
+
+		if ( swap16 ) {
+			//	Frame is built with swapped bytes, in place of the copy I2C_device::reg_w() makes
+			uint8_t	b[ n + 1 ];
+
+			b[ 0 ]	= ai ? reg_adr + done : reg_adr;
+
+			for ( int i = 0; i < n; i++ )
+				b[ i + 1 ]	= data[ (done + i) ^ 1 ];
+
+			r	= tx( b, n + 1 );
+			r	= (r < 0) ? r : n;
+		}
+		else {
+			r	= I2C_device::reg_w( ai ? reg_adr + done : reg_adr, data + done, n );
+		}
+
+		if ( r < 0 )
+			return r;
+	}
+
+	return size;
+}
+
+int GPIO_base::raw_r( uint8_t reg_adr, uint8_t* data, uint16_t size )
+{
+	if ( transportp ) {
+		int	r	= transportp->reg_r( i2c_addr, reg_adr, data, size );
+
+		if ( GPIO_TRANSPORT::NOT_HANDLED != r )
+			return r;
+	}
+
+	const int	chunk	= GPIO_NXP_WIRE_BUFFER;
+	bool		ai		= auto_increment && (reg_adr & auto_increment);
+
+	if ( size <= chunk )
+		return I2C_device::reg_r( reg_adr, data, size );
+
+	for ( int done = 0; done < size; done += chunk ) {
+		int	n	= (chunk < size - done) ? chunk : size - done;
+		int	r	= I2C_device::reg_r( ai ? reg_adr + done : reg_adr, data + done, n );
+
+		if ( r < 0 )
+			return r;
+	}
+
+	return size;
+}
+
+void GPIO_base::retry_policy( int retries, uint32_t backoff, uint32_t deadline )
+{
+	max_retries	= retries;
+	backoff_us	= backoff;
+	deadline_us	= deadline;
+
+#if defined( WIRE_HAS_TIMEOUT )
+	if ( deadline )
+		wirep->setWireTimeout( deadline, true );
+#endif
+}
+
+void GPIO_base::recovery( int sda_pin, int scl_pin, uint32_t clock )
+{
+	sda		= sda_pin;
+	scl		= scl_pin;
+
+	if ( clock )
+		recovery_clock	= clock;
+}
+
+void GPIO_base::bus_clock( uint32_t clock )
+{
+	recovery_clock	= clock;
+}
+
+void GPIO_base::bus_recovery( void )
+{
+	//	Only for Wire. Not for transport and SPI devices
+	if ( (sda < 0) || (scl < 0) || transportp || !wire() )
+		return;
+
+	//	Release the pins from I2C peripheral
+	wirep->end();
+
+	//	Open-drain emulation: HIGH by pull-up, LOW by driving
+	pinMode( sda, INPUT_PULLUP );
+	pinMode( scl, INPUT_PULLUP );
+	delayMicroseconds( 5 );
+
+	//	Clock out the byte which the target is sending
+	for ( int i = 0; (i < 9) && !digitalRead( sda ); i++ ) {
+		pinMode( scl, OUTPUT );
+		digitalWrite( scl, LOW );
+		delayMicroseconds( 5 );
+		pinMode( scl, INPUT_PULLUP );
+		delayMicroseconds( 5 );
+	}
+
+	//	STOP condition
+	pinMode( scl, OUTPUT );
+	digitalWrite( scl, LOW );
+	pinMode( sda, OUTPUT );
+	digitalWrite( sda, LOW );
+	delayMicroseconds( 5 );
+	pinMode( scl, INPUT_PULLUP );
+	delayMicroseconds( 5 );
+	pinMode( sda, INPUT_PULLUP );
+	delayMicroseconds( 5 );
+
+	wirep->begin();
+
+	//	Clock before recovery (like one set by BUS_MANAGER::negotiate_clock()). Wire default if not known
+	if ( recovery_clock )
+		wirep->setClock( recovery_clock );
+}
+
+GPIO_base::scope::scope( GPIO_base* dev ) : dp( dev ), g( dev->lockp )
+{
+	if ( !dp->depth++ ) {
+		dp->status		= XFER_OK;
+		dp->elapsed_us	= 0;
+		dp->n_retries	= 0;
+	}
+}
+
+GPIO_base::scope::~scope()
+{
+	dp->depth--;
+}
+
+GPIO_base::xfer_status GPIO_base::last_status( void )
+{
+	return status;
+}
+
+uint32_t GPIO_base::last_elapsed( void )
+{
+	return elapsed_us;
+}
+
+int GPIO_base::last_retries( void )
+{
+	return n_retries;
+}
+
+bool GPIO_base::has_register( access_word w )
+{
+	return 0xFF != *(arp + w);
+}
+
+uint64_t GPIO_base::pack( const uint8_t* vp )
+{
+	uint64_t	image	= 0;
+
+	for ( int i = n_ports - 1; 0 <= i; i-- )
+		image	= (image << 8) | vp[ i ];
+
+	return image;
+}
+
+uint8_t* GPIO_base::unpack( uint64_t image, uint8_t* vp )
+{
+	for ( int i = 0; i < n_ports; i++ ) {
+		vp[ i ]	= (uint8_t)image;
+		image	>>= 8;
+	}
+
 	return vp;
 }
 
-void GPIO_base::write_port( access_word w, uint8_t value, int port_num )
+uint64_t GPIO_base::read_image( access_word w )
 {
-	write_r8( *(arp + w) + port_num, value );
+	uint8_t	b[ n_ports ];
+
+	return pack( read_port( w, b ) );
 }
 
-void GPIO_base::write_port16( access_word w, uint16_t value, int port_num )
+void GPIO_base::write_image( access_word w, uint64_t image )
 {
-	write_r16( *(arp + w) + port_num, value );
+	uint8_t	b[ n_ports ];
+
+	write_port( w, unpack( image, b ) );
 }
 
-uint8_t GPIO_base::read_port( access_word w, int port_num )
+uint32_t GPIO_base::bus_time( int n_bytes, uint32_t clock, bool read )
 {
-	return read_r8( *(arp + w) + port_num );
+	//	START + target address + register pointer + data + STOP.
+	//	Read has repeated-START and target address again
+	uint32_t	clocks	= 1 + 9 + 9 + 9 * n_bytes + 1;
+
+	if ( read )
+		clocks	+= 1 + 9;
+
+	return (clocks * 1000000UL + clock - 1) / clock;
 }
 
-uint16_t GPIO_base::read_port16( access_word w, int port_num )
+uint32_t GPIO_base::max_clock( void )
 {
-	return read_r16( *(arp + w) + port_num );
+	return 1000000;	//	Fast-mode Plus
+}
+
+bool GPIO_base::link_test( int repeat )
+{
+	static const uint8_t	patterns[]	= { 0x55, 0xAA, 0x00, 0xFF };
+
+	scope	sc( this );
+
+	if ( !ping() )
+		return false;
+
+	if ( !has_register( POLARITY ) )
+		return true;
+
+	int		n_bytes	= field_length( POLARITY );
+	uint8_t	saved[ n_bytes ];
+	uint8_t	w[ n_bytes ];
+	uint8_t	r[ n_bytes ];
+	bool	pass	= true;
+
+	read_port( POLARITY, saved );
+
+	for ( int i = 0; pass && (i < repeat); i++ ) {
+		for ( unsigned int p = 0; pass && (p < sizeof( patterns )); p++ ) {
+			for ( int j = 0; j < n_bytes; j++ )
+				w[ j ]	= patterns[ p ] ^ (j * 0x11);
+
+			write_port( POLARITY, w );
+			read_port( POLARITY, r );
+
+			pass	= !memcmp( w, r, n_bytes );
+		}
+	}
+
+	write_port( POLARITY, saved );
+
+	return pass;
 }
 
 void GPIO_base::print_bin( uint8_t v )
@@ -209,6 +751,11 @@ PCA9554::~PCA9554()
 {
 }
 
+uint32_t PCA9554::max_clock( void )
+{
+	return 400000;
+}
+
 constexpr uint8_t PCA9554::access_ref[];
 
 
@@ -228,6 +775,11 @@ PCA9555::~PCA9555()
 {
 }
 
+uint32_t PCA9555::max_clock( void )
+{
+	return 400000;
+}
+
 constexpr uint8_t PCA9555::access_ref[];
 
 
@@ -327,7 +879,13 @@ constexpr uint8_t PCAL6534::access_ref[];
 /* ******** PCAL9722 ******** */
 
 GPIO_SPI::GPIO_SPI( uint8_t dev_address, int nbits, const uint8_t* arp, uint8_t ai )
-	: GPIO_base( dev_address, nbits, arp, ai )
+	: GPIO_base( dev_address, nbits, arp, ai ), spip( NULL ), cs( -1 ), leader( this ), pipelining( false ), deferring( false ), pl_frames( 0 ), pl_bytes( 0 )
+{
+	spi_setting	= SPISettings( 1000000, MSBFIRST, SPI_MODE0 );
+}
+
+GPIO_SPI::GPIO_SPI( SPIClass& spi, int cs_pin, uint8_t dev_address, int nbits, const uint8_t* arp, uint8_t ai )
+	: GPIO_base( dev_address, nbits, arp, ai ), spip( &spi ), cs( cs_pin ), leader( this ), pipelining( false ), deferring( false ), pl_frames( 0 ), pl_bytes( 0 )
 {
 	spi_setting	= SPISettings( 1000000, MSBFIRST, SPI_MODE0 );
 }
@@ -338,73 +896,256 @@ GPIO_SPI::~GPIO_SPI()
 
 int GPIO_SPI::reg_w( uint8_t reg_adr, const uint8_t *data, uint16_t size )
 {
-	uint8_t	w_data[ size + 2 ];
-	uint8_t	r_data[ size + 2 ];
-	
-	w_data[ 0 ]	= (i2c_addr << 1);
-	w_data[ 1 ]	= reg_adr | auto_increment;
-	memcpy( w_data + 2, data, size );
-	
-	txrx( w_data, r_data, size + 2 );
-	
-	return size;
+	return transaction( true, reg_adr | auto_increment, (uint8_t*)data, size );
 }
 
 int GPIO_SPI::reg_w( uint8_t reg_adr, uint8_t data )
 {
-	uint8_t	w_data[ 3 ];
-	uint8_t	r_data[ 3 ];
+	return transaction( true, reg_adr, &data, 1 );
+}
+
+int GPIO_SPI::reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size )
+{
+	return transaction( false, reg_adr | auto_increment, data, size );
+}
+
+uint8_t GPIO_SPI::reg_r( uint8_t reg_adr )
+{
+	uint8_t	data	= 0;
 	
-	w_data[ 0 ]	= i2c_addr << 1;
-	w_data[ 1 ]	= reg_adr;
-	w_data[ 2 ]	= data;
+	transaction( false, reg_adr, &data, 1 );
+
+	return data;
+} 
+
+int GPIO_SPI::raw_w( uint8_t reg_adr, const uint8_t* data, uint16_t size )
+{
+	uint8_t	w_data[ size + 2 ];
+	uint8_t	r_data[ size + 2 ];
 	
-	txrx( w_data, r_data, 3 );
+	w_data[ 0 ]	= (i2c_addr << 1);
+	w_data[ 1 ]	= reg_adr;
+
+	if ( swap16 ) {
+		for ( int i = 0; i < size; i++ )
+			w_data[ i + 2 ]	= data[ i ^ 1 ];
+	}
+	else {
+		memcpy( w_data + 2, data, size );
+	}
 	
-	return 1;
+	return (frame( w_data, r_data, size + 2 ) < 0) ? -1 : size;
 }
 
-int GPIO_SPI::reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size )
+int GPIO_SPI::raw_r( uint8_t reg_adr, uint8_t* data, uint16_t size )
 {
-	uint8_t	w_data[ size + 2 ]	= { 0 };
+	uint8_t	w_data[ size + 2 ];
 	uint8_t	r_data[ size + 2 ];
+	int		r;
 
+	memset( w_data, 0, size + 2 );
 	w_data[ 0 ]	= (i2c_addr << 1) | 0x1;
-	w_data[ 1 ]	= reg_adr | auto_increment;
+	w_data[ 1 ]	= reg_adr;
 
-	txrx( w_data, r_data, size + 2 );
-	
-	memcpy( data, r_data + 2, size );
+	r	= frame( w_data, r_data, size + 2, data );
+
+	//	Caller uses the data on return, unless it asked for a deferred read into its own buffer
+	if ( (0 <= r) && leader->pipelining && !deferring )
+		r	= leader->flush_pipeline();
+
+	return (r < 0) ? -1 : size;
+}
+
+void GPIO_SPI::write_stream( access_word w, const uint8_t* vp, int length, int port_num )
+{
+	scope	sc( this );
+
+	//	Without auto-increment flag
+	transaction( true, *(arp + w) + port_num, (uint8_t*)vp, length );
+}
+
+int GPIO_SPI::frame( uint8_t* w_data, uint8_t* r_data, int size, uint8_t* dest )
+{
+	if ( leader->pipelining && leader->enqueue( w_data, size, dest ) )
+		return size;
+
+	uint16_t	n	= size;
+	int			r	= GPIO_TRANSPORT::NOT_HANDLED;
+
+	if ( transportp )
+		r	= transportp->txrx( w_data, r_data, size );
+
+	if ( GPIO_TRANSPORT::NOT_HANDLED == r )
+		r	= sequence( w_data, r_data, &n, 1 );
+
+	if ( r < 0 )
+		return r;
+
+	if ( dest )
+		memcpy( dest, r_data + 2, size - 2 );
 
 	return size;
 }
 
-uint8_t GPIO_SPI::reg_r( uint8_t reg_adr )
+bool GPIO_SPI::enqueue( const uint8_t* w_data, int size, uint8_t* dest )
 {
-	uint8_t	w_data[ 3 ];
-	uint8_t	r_data[ 3 ];
-	
-	w_data[ 0 ]	= (i2c_addr << 1) | 0x1;
-	w_data[ 1 ]	= reg_adr;
-	w_data[ 2 ]	= 0;
-	
-	txrx( w_data, r_data, 3 );
-	
-	return r_data[ 2 ];
-} 
+	if ( (PIPELINE_FRAMES <= pl_frames) || (PIPELINE_BUFFER < pl_bytes + size) )
+		flush_pipeline();
+
+	if ( PIPELINE_BUFFER < size )
+		return false;
+
+	memcpy( pl_w + pl_bytes, w_data, size );
+	pl_size[ pl_frames ]	= size;
+	pl_dest[ pl_frames ]	= dest;
+	pl_bytes	+= size;
+	pl_frames++;
+
+	return true;
+}
+
+int GPIO_SPI::sequence( uint8_t* w_data, uint8_t* r_data, const uint16_t* sizes, int n )
+{
+	int	total	= 0;
+
+	if ( !spip ) {
+		for ( int i = 0; i < n; i++ ) {
+			txrx( w_data + total, r_data + total, sizes[ i ] );
+			total	+= sizes[ i ];
+		}
+
+		return total;
+	}
+
+	//	All frames in one SPI transaction. CS is deasserted between frames
+	spip->beginTransaction( spi_setting );
+
+	for ( int i = 0; i < n; i++ ) {
+		memcpy( r_data + total, w_data + total, sizes[ i ] );
+
+		digitalWrite( cs, LOW );
+		spip->transfer( r_data + total, sizes[ i ] );
+		digitalWrite( cs, HIGH );
+
+		total	+= sizes[ i ];
+	}
+
+	spip->endTransaction();
+
+	return total;
+}
+
+void GPIO_SPI::group( GPIO_SPI& leader_dev )
+{
+	leader	= leader_dev.leader;
+	bus_lock( leader->bus_lock() );
+}
+
+void GPIO_SPI::begin_pipeline( void )
+{
+	if ( leader != this ) {
+		leader->begin_pipeline();
+		return;
+	}
+
+	if ( lockp )
+		lockp->lock();
+
+	pipelining	= true;
+	pl_frames	= 0;
+	pl_bytes	= 0;
+}
+
+int GPIO_SPI::end_pipeline( void )
+{
+	if ( leader != this )
+		return leader->end_pipeline();
+
+	int	r	= flush_pipeline();
+
+	pipelining	= false;
+
+	if ( lockp )
+		lockp->unlock();
+
+	return r;
+}
+
+void GPIO_SPI::read_port_deferred( access_word w, uint8_t* vp )
+{
+	deferring	= true;
+	read_field( w, vp );
+	deferring	= false;
+}
+
+void GPIO_SPI::write_read_port( access_word w_out, const uint8_t* out, access_word w_in, uint8_t* in )
+{
+	begin_pipeline();
+	write_port( w_out, out );
+	read_port_deferred( w_in, in );
+	end_pipeline();
+}
+
+int GPIO_SPI::flush_pipeline( void )
+{
+	int	r;
+
+	if ( !pl_frames )
+		return 0;
+
+	if ( !transportp || (GPIO_TRANSPORT::NOT_HANDLED == (r = transportp->txrx_sequence( pl_w, pl_r, pl_size, pl_frames ))) )
+		r	= sequence( pl_w, pl_r, pl_size, pl_frames );
+
+	for ( int i = 0, offset = 0; i < pl_frames; offset += pl_size[ i++ ] )
+		if ( pl_dest[ i ] )
+			memcpy( pl_dest[ i ], pl_r + offset + 2, pl_size[ i ] - 2 );
+
+	pl_frames	= 0;
+	pl_bytes	= 0;
+
+	return r;
+}
+
+uint32_t GPIO_SPI::bus_time( int n_bytes, uint32_t clock, bool )
+{
+	//	Device address byte + register address byte + data
+	uint32_t	clocks	= 8 * (2 + n_bytes);
+
+	return (clocks * 1000000UL + clock - 1) / clock;
+}
+
+TwoWire* GPIO_SPI::wire( void )
+{
+	return NULL;
+}
+
+SPIClass* GPIO_SPI::spi( void )
+{
+	return spip ? spip : &SPI;
+}
 
 PCAL97xx_base::PCAL97xx_base( uint8_t dev_address, const int nbits, const uint8_t arp[], uint8_t ai ) :
 	GPIO_SPI( dev_address, nbits, arp, ai )
 {
 }
 
+PCAL97xx_base::PCAL97xx_base( SPIClass& spi, int cs_pin, uint8_t dev_address, const int nbits, const uint8_t arp[], uint8_t ai ) :
+	GPIO_SPI( spi, cs_pin, dev_address, nbits, arp, ai )
+{
+}
+
 PCAL97xx_base::~PCAL97xx_base()
 {
 }
 
 
 PCAL9722::PCAL9722( uint8_t dev_address ) :
-	PCAL97xx_base( dev_address, 24, access_ref, 0x80 )
+	PCAL97xx_base( dev_address, 24, access_ref, 0x80 ), rst_pin( -1 )
+{
+}
+
+PCAL9722::PCAL9722( SPIClass& spi, int cs_pin, int reset_pin, uint8_t dev_address ) :
+	PCAL97xx_base( spi, cs_pin, dev_address, 24, access_ref, 0x80 ), rst_pin( reset_pin )
 {
 }
 
@@ -414,11 +1155,18 @@ PCAL9722::~PCAL9722()
 
 void PCAL9722::begin( board env )
 {
-	if ( env ) {
-		pinMode( RESET_PIN_PCAL9722, OUTPUT );
-		digitalWrite( RESET_PIN_PCAL9722, 0 );
+	int	reset	= (0 <= rst_pin) ? rst_pin : (env ? RESET_PIN_PCAL9722 : -1);
+
+	if ( 0 <= cs ) {
+		pinMode( cs, OUTPUT );
+		digitalWrite( cs, HIGH );
+	}
+
+	if ( 0 <= reset ) {
+		pinMode( reset, OUTPUT );
+		digitalWrite( reset, 0 );
 		delay( 1 );
-		digitalWrite( RESET_PIN_PCAL9722, 1 );
+		digitalWrite( reset, 1 );
 	}
 }
 
@@ -12,6 +12,35 @@
 #include	<stdint.h>
 
 #include	<I2C_device.h>
+#include	"BUS_LOCK.h"
+#include	"GPIO_TRANSPORT.h"
+
+/** Size of Wire buffer
+ *
+ *	I2C bursts are split into chunks fitting in this size.
+ *	Can be overridden by defining GPIO_NXP_WIRE_BUFFER before including this file
+ */
+#if !defined( GPIO_NXP_WIRE_BUFFER )
+#if defined( BUFFER_LENGTH )			//	AVR, megaAVR
+#define	GPIO_NXP_WIRE_BUFFER	BUFFER_LENGTH
+#elif defined( I2C_BUFFER_LENGTH )		//	ESP32
+#define	GPIO_NXP_WIRE_BUFFER	I2C_BUFFER_LENGTH
+#elif defined( WIRE_BUFFER_SIZE )		//	RP2040
+#define	GPIO_NXP_WIRE_BUFFER	WIRE_BUFFER_SIZE
+#else
+#define	GPIO_NXP_WIRE_BUFFER	32
+#endif
+#endif
+
+/** Host byte order
+ *
+ *	'1' on little endian host. 16 bit values are transferred with swapped bytes, since register 'A' is the upper byte
+ */
+#if defined( __BYTE_ORDER__ ) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define	GPIO_NXP_LITTLE_ENDIAN	0
+#else
+#define	GPIO_NXP_LITTLE_ENDIAN	1
+#endif
 
 /** Descriptors for accessing GPIO
  *
@@ -31,6 +60,7 @@ enum access_word : uint8_t
 	INT_MASK,
 	INT_STATUS,
 	OUTPUT_PORT_CONFIG,
+	INT_EDGE,
 	NUM_access_word, 
 };
 
@@ -48,6 +78,21 @@ public:
 		NONE,
 		ARDUINO_SHIELD,
 	};
+
+	/** Interrupt edge settings for interrupt_edge() */
+	enum edge {
+		EDGE_LEVEL_CHANGE,
+		EDGE_RISING,
+		EDGE_FALLING,
+		EDGE_ANY,
+	};
+
+	/** Status of last transaction */
+	enum xfer_status {
+		XFER_OK,		/**< Done */
+		XFER_ERROR,		/**< Failed after all retries */
+		XFER_TIMEOUT,	/**< Deadline passed before done */
+	};
 	
 	/** Number of IO bits */
 	const int	n_bits;
@@ -151,6 +196,17 @@ public:
 	 */
 	virtual void		write_port( access_word w, const uint8_t* vp );
 
+	/** Write multiple port method
+	 * 
+	 *	Consecutive ports register access function using word of 'access_word'
+	 *
+	 * @param w			Accsess word. This should be choosen from access_word'
+	 * @param vp		Pointer to an array of values. The array should have 'length' length
+	 * @param port_num	First port number
+	 * @param length	Number of ports
+	 */
+	virtual void		write_port( access_word w, const uint8_t* vp, int port_num, int length );
+
 	/** Write all port method
 	 * 
 	 *	All port 16 bit register access function using word of 'access_word'
@@ -192,11 +248,13 @@ public:
 
 	/** Write single port method
 	 * 
-	 *	Single port 16 bit register access function using word of 'access_word'
+	 *	Single port 16 bit register access function using word of 'access_word'. 
+	 *	Only the upper byte is written if 'port_num' is the last port of the block. 
+	 *	Nothing is done if 'port_num' is out of the block
 	 *
 	 * @param w			Accsess word. This should be choosen from access_word'
 	 * @param value		Value to be written into a register
-	 * @param port_num	Option, to specify port number
+	 * @param port_num	Option, to specify port number of the first (upper) byte. Use write_pair16() to specify by 16 bit index
 	 */
 	virtual void		write_port16( access_word w, uint16_t value, int port_num = 0 );
 
@@ -212,27 +270,392 @@ public:
 
 	/** Read single port method
 	 * 
-	 *	Single port 16 bit register access function using word of 'access_word'
+	 *	Single port 16 bit register access function using word of 'access_word'. 
+	 *	Lower byte is 0 if 'port_num' is the last port of the block
 	 *
 	 * @param w			Accsess word. This should be choosen from access_word'
-	 * @param port_num	Option, to specify port number
-	 * @return Register read value
+	 * @param port_num	Option, to specify port number of the first (upper) byte. Use read_pair16() to specify by 16 bit index
+	 * @return Register read value. '0' if 'port_num' is out of the block
 	 */
 	virtual uint16_t	read_port16( access_word w, int port_num = 0 );
 
+	/** Write single 16 bit register method
+	 * 
+	 *	Same as write_port16() but the register is specified by 16 bit index (port pair)
+	 *
+	 * @param w			Accsess word. This should be choosen from access_word'
+	 * @param value		Value to be written into a register
+	 * @param pair		16 bit index. Accesses port 'pair * 2' and next
+	 */
+	void				write_pair16( access_word w, uint16_t value, int pair );
+
+	/** Read single 16 bit register method
+	 * 
+	 *	Same as read_port16() but the register is specified by 16 bit index (port pair)
+	 *
+	 * @param w			Accsess word. This should be choosen from access_word'
+	 * @param pair		16 bit index. Accesses port 'pair * 2' and next
+	 * @return Register read value
+	 */
+	uint16_t			read_pair16( access_word w, int pair );
+
+	/** Field length
+	 * 
+	 *	Number of bytes of a register block. 
+	 *	Blocks of DRIVE_STRENGTH and INT_EDGE have 2 bits per pin, others have 1 bit per pin. 
+	 *	Reserved registers after the block (like 'reserved0' in PCAL6534) are not included
+	 *
+	 * @param w		Accsess word. This should be choosen from access_word'
+	 * @return	Number of bytes
+	 */
+	int					field_length( access_word w );
+
+	/** Write register block
+	 * 
+	 *	Packed register image is written in one burst (without copy) on auto-increment devices
+	 *
+	 * @param w			Accsess word. This should be choosen from access_word'
+	 * @param vp		Pointer to register image in register address order
+	 * @param offset	Option, byte offset in the block
+	 * @param length	Option, number of bytes. Rest of block from 'offset' if negative
+	 */
+	void				write_field( access_word w, const uint8_t* vp, int offset = 0, int length = -1 );
+
+	/** Read register block
+	 * 
+	 *	Packed register image is read in one burst on auto-increment devices
+	 *
+	 * @param w			Accsess word. This should be choosen from access_word'
+	 * @param vp		Pointer to buffer for register image in register address order
+	 * @param offset	Option, byte offset in the block
+	 * @param length	Option, number of bytes. Rest of block from 'offset' if negative
+	 */
+	void				read_field( access_word w, uint8_t* vp, int offset = 0, int length = -1 );
+
+	/** Write stream into single port
+	 * 
+	 *	Writes values into a register of single port repeatedly in one transaction.
+	 *	Register pointer is kept on 8 bit devices and on devices which can disable auto-increment. 
+	 *	16 bit devices toggle the pointer in port pair, so the values are written one by one on those. 
+	 *
+	 * @param w			Accsess word. This should be choosen from access_word'
+	 * @param vp		Pointer to an array of values
+	 * @param length	Number of values
+	 * @param port_num	Option, to specify port number
+	 */
+	virtual void		write_stream( access_word w, const uint8_t* vp, int length, int port_num = 0 );
+
+	/** Write 2 bit per pin register
+	 * 
+	 *	Sets a 2 bit field of pins in registers which have 2 bits per pin (DRIVE_STRENGTH and INT_EDGE). 
+	 *	Only changed registers are written. 
+	 *
+	 * @param w		Accsess word. DRIVE_STRENGTH or INT_EDGE
+	 * @param pins	Bit image of pins
+	 * @param value	2 bit value to be set
+	 */
+	void				write_pin2( access_word w, uint64_t pins, uint8_t value );
+
+	/** Read 2 bit per pin register
+	 * 
+	 * @param w		Accsess word. DRIVE_STRENGTH or INT_EDGE
+	 * @param value	2 bit value to find
+	 * @return	Bit image of pins which have the value
+	 */
+	uint64_t			read_pin2( access_word w, uint8_t value );
+
+	/** Set output drive strength
+	 * 
+	 * @param pins	Bit image of pins
+	 * @param level	Drive strength. 0 (x0.25) ~ 3 (x1)
+	 */
+	void				drive_strength( uint64_t pins, uint8_t level );
+
+	/** Set interrupt edge
+	 * 
+	 * @param pins	Bit image of pins
+	 * @param e		EDGE_LEVEL_CHANGE, EDGE_RISING, EDGE_FALLING or EDGE_ANY
+	 */
+	void				interrupt_edge( uint64_t pins, edge e );
+
+	/** Set bus lock
+	 *
+	 *	Devices on same bus should share one BUS_LOCK instance. 
+	 *	Each method takes the lock while it accesses the device. No locking if NULL (default)
+	 *
+	 * @param lock	Pointer to BUS_LOCK instance
+	 */
+	void				bus_lock( BUS_LOCK* lock );
+
+	/** Get bus lock
+	 *
+	 *	Lock-scoped batch can be done with the lock, like
+	 *		{ BUS_LOCK::guard g( gpio.bus_lock() ); gpio.output( 0, v ); gpio.input( 1 ); }
+	 *
+	 * @return	Pointer to BUS_LOCK instance
+	 */
+	BUS_LOCK*			bus_lock( void );
+
+	/** Set transport
+	 *
+	 *	Register accesses go through given transport instead of I2C_device (Wire) or SPI. 
+	 *	Accesses which the transport returns GPIO_TRANSPORT::NOT_HANDLED are done by the default path. 
+	 *	Default transport is used if NULL (default)
+	 *
+	 * @param tp	Pointer to GPIO_TRANSPORT instance
+	 */
+	void				transport( GPIO_TRANSPORT* tp );
+
+	/** Get transport
+	 *
+	 * @return	Pointer to GPIO_TRANSPORT instance. NULL if default transport is used
+	 */
+	GPIO_TRANSPORT*		transport( void );
+
+	/** I2C bus of the device
+	 *
+	 * @return	Pointer to TwoWire instance. NULL for SPI devices
+	 */
+	virtual TwoWire*	wire( void );
+
+	/** SPI bus of the device
+	 *
+	 * @return	Pointer to SPIClass instance. NULL for I2C devices
+	 */
+	virtual SPIClass*	spi( void );
+
+	/** Multiple register write
+	 * 
+	 *	On Wire, a burst larger than GPIO_NXP_WIRE_BUFFER is split into chunks. 
+	 *	If 'reg' has auto-increment flag, register address of each chunk continues from previous chunk
+	 *
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data buffer
+	 * @param size data size
+	 * @return transferred data size
+	 */
+	virtual int			reg_w( uint8_t reg_adr, const uint8_t *data, uint16_t size );
+
+	/** Single register write
+	 * 
+	 * @param reg register index/address/pointer
+	 * @param data data
+	 * @return transferred data size
+	 */
+	virtual int			reg_w( uint8_t reg_adr, uint8_t data );
+
+	/** Multiple register read
+	 * 
+	 *	On Wire, a burst larger than GPIO_NXP_WIRE_BUFFER is split into chunks same as reg_w()
+	 *
+	 * @param reg register index/address/pointer
+	 * @param data pointer to data buffer
+	 * @param size data size
+	 * @return transferred data size
+	 */
+	virtual int			reg_r( uint8_t reg_adr, uint8_t *data, uint16_t size );
+
+	/** Single register read
+	 * 
+	 * @param reg register index/address/pointer
+	 * @return read data
+	 */
+	virtual uint8_t		reg_r( uint8_t reg_adr );
+
+	/** Register overwriting with bit-mask
+	 * 
+	 *	Read and write are done in one method call: bus lock is held and last_status() keeps the first error
+	 *
+	 * @param reg register index/address/pointer
+	 * @param mask bit-mask to protect overwriting
+	 * @param value value to overwrite
+	 */
+	void				bit_op8(  uint8_t reg,  uint8_t mask,  uint8_t value );
+	void				bit_op16( uint8_t reg, uint16_t mask, uint16_t value );
+
+	/** Register availability
+	 *
+	 * @param w		Accsess word. This should be choosen from access_word'
+	 * @return	'true' if the device has the register
+	 */
+	bool				has_register( access_word w );
+
+	/** Pack port values into a bit image
+	 *
+	 * @param vp	Pointer to an array of values. The array should have 'n_ports' length
+	 * @return	Bit image. Bit0 of port0 is placed at bit0 of the image
+	 */
+	uint64_t			pack( const uint8_t* vp );
+
+	/** Unpack a bit image into port values
+	 *
+	 * @param image	Bit image. Bit0 of port0 is placed at bit0 of the image
+	 * @param vp	Pointer to an array of values. The array should have 'n_ports' length
+	 * @return	Pointer to vp
+	 */
+	uint8_t*			unpack( uint64_t image, uint8_t* vp );
+
+	/** Read all port as a bit image
+	 *
+	 * @param w		Accsess word. This should be choosen from access_word'
+	 * @return	Bit image. Bit0 of port0 is placed at bit0 of the image
+	 */
+	uint64_t			read_image( access_word w );
+
+	/** Write all port from a bit image
+	 *
+	 * @param w		Accsess word. This should be choosen from access_word'
+	 * @param image	Bit image. Bit0 of port0 is placed at bit0 of the image
+	 */
+	void				write_image( access_word w, uint64_t image );
+
+	/** Bus time estimation
+	 *
+	 *	Estimates time for one register access transaction which transfers 'n_bytes' of data
+	 *
+	 * @param n_bytes	Number of data bytes
+	 * @param clock		Bus clock frequency in Hz
+	 * @param read		'true' for read transaction
+	 * @return	Estimated time in microseconds
+	 */
+	virtual uint32_t	bus_time( int n_bytes, uint32_t clock, bool read = false );
+
+	/** Maximum bus clock
+	 *
+	 * @return	Maximum bus clock frequency of the device in Hz
+	 */
+	virtual uint32_t	max_clock( void );
+
+	/** Link test
+	 *
+	 *	Checks the device responds and register values are read back correctly. 
+	 *	Test patterns are written into POLARITY registers and the registers are restored after the test. 
+	 *	Only ping is done if the device doesn't have POLARITY registers. 
+	 *
+	 * @param repeat	Number of times to repeat the patterns
+	 * @return	'true' if passed
+	 */
+	bool				link_test( int repeat = 1 );
+
+	/** Retry policy
+	 *
+	 *	A failed register access is retried with exponential backoff (doubled on each retry). 
+	 *	Retry is stopped when next try would pass the deadline. 
+	 *	If the platform Wire has timeout feature (WIRE_HAS_TIMEOUT), it is set to the deadline. 
+	 *
+	 * @param retries	Number of retries. 0 to disable
+	 * @param backoff	First backoff time in microseconds
+	 * @param deadline	Deadline of a transaction in microseconds. 0 for no deadline
+	 */
+	void				retry_policy( int retries, uint32_t backoff = 100, uint32_t deadline = 0 );
+
+	/** Bus recovery setting
+	 *
+	 *	When a register access fails, Wire is released (Wire.end()), SCL is pulsed until SDA is released, 
+	 *	STOP condition is generated and Wire is re-initialized, before retry. 
+	 *	Not performed when a transport is set, since the bus is not driven by Wire. 
+	 *
+	 * @param sda_pin	SDA pin
+	 * @param scl_pin	SCL pin. -1 to disable recovery
+	 * @param clock		Bus clock to be restored after re-initialization. 0 to keep the clock given by bus_clock()
+	 */
+	void				recovery( int sda_pin, int scl_pin, uint32_t clock = 0 );
+
+	/** Bus clock notification
+	 *
+	 *	Tells the clock currently set on the bus, to be restored after bus recovery. 
+	 *	BUS_MANAGER calls this when it changes the clock. 
+	 *	If no clock is known, Wire default is used after recovery. 
+	 *
+	 * @param clock		Bus clock in Hz
+	 */
+	void				bus_clock( uint32_t clock );
+
+	/** Bus recovery
+	 *
+	 *	Performs recovery sequence immediately. Pins should be set by recovery( sda_pin, scl_pin )
+	 */
+	void				bus_recovery( void );
+
+	/** Status of last method call
+	 *
+	 *	A method call (like write_pin2() or bit_op8()) can make several transactions. 
+	 *	The first error in the call is kept, not overwritten by following successful transactions. 
+	 *	Both I2C and SPI (PCAL9722) devices report it. 
+	 *
+	 * @return	xfer_status
+	 */
+	xfer_status			last_status( void );
+
+	/** Elapsed time of last method call
+	 *
+	 * @return	Elapsed time in microseconds including retries, total of transactions in the call
+	 */
+	uint32_t			last_elapsed( void );
+
+	/** Number of retries in last method call
+	 *
+	 * @return	Number of retries, total of transactions in the call
+	 */
+	int					last_retries( void );
+
 	static void	print_bin( uint8_t v );
 
-protected:	
+protected:
 	const uint8_t	auto_increment;
+	const uint8_t*	arp;
+	BUS_LOCK*		lockp;
+	GPIO_TRANSPORT*	transportp;
+
+	/** Bytes of each pair are swapped in the frame of a write (set by write_port16()) */
+	bool			swap16;
+
+	/** Register access with retries, status and elapsed time
+	 *
+	 *	All register accesses go through this. Bus transfer is done by raw_w()/raw_r()
+	 *
+	 * @return	Transferred data size. Negative value for error
+	 */
+	int			transaction( bool write, uint8_t reg_adr, uint8_t* data, uint16_t size );
+
+	/** Bus transfer of register write. Overridden for SPI devices */
+	virtual int	raw_w( uint8_t reg_adr, const uint8_t* data, uint16_t size );
+
+	/** Bus transfer of register read. Overridden for SPI devices */
+	virtual int	raw_r( uint8_t reg_adr, uint8_t* data, uint16_t size );
+
+	/** Scope of a public method call
+	 *
+	 *	Holds the bus lock and clears last_status() / last_elapsed() / last_retries() 
+	 *	at entry of outermost call, so that nested calls accumulate into one result. 
+	 */
+	class scope {
+	public:
+		scope( GPIO_base* dev );
+		~scope();
+	private:
+		GPIO_base*		dp;
+		BUS_LOCK::guard	g;
+		scope( const scope& );
+		scope&	operator=( const scope& );
+	};
 
 private:
-	const uint8_t*	arp;
-	bool			endian;
-	
 	static constexpr int RESET_PIN	= 8;
 	static constexpr int ADDR_PIN	= 9;
-	
-	void init( void );
+
+	TwoWire*		wirep;
+	int				max_retries;
+	uint32_t		backoff_us;
+	uint32_t		deadline_us;
+	int				sda;
+	int				scl;
+	uint32_t		recovery_clock;
+	xfer_status		status;
+	uint32_t		elapsed_us;
+	int				n_retries;
+	int				depth;
+
 };
 
 /** PCA9554 class
@@ -266,6 +689,12 @@ public:
 	/** Destractor */
 	virtual ~PCA9554();
 
+	/** Maximum bus clock
+	 *
+	 * @return	400kHz (Fast-mode)
+	 */
+	virtual uint32_t	max_clock( void );
+
 	static constexpr uint8_t	access_ref[ NUM_access_word ]	= {
 		Input_Port,			//	IN,
 		Output_Port,		//	OUT
@@ -278,6 +707,7 @@ public:
 		0xFF,	//	INT_MASK			** CANNOT BE USED **
 		0xFF,	//	INT_STATUS			** CANNOT BE USED **
 		0xFF,	//	OUTPUT_PORT_CONFIG	** CANNOT BE USED **
+		0xFF,	//	INT_EDGE			** CANNOT BE USED **
 	};
 	
 #if DOXYGEN_ONLY
@@ -553,6 +983,12 @@ public:
 	/** Destractor */
 	virtual ~PCA9555();
 
+	/** Maximum bus clock
+	 *
+	 * @return	400kHz (Fast-mode)
+	 */
+	virtual uint32_t	max_clock( void );
+
 	static constexpr uint8_t	access_ref[ NUM_access_word ]	= {
 		Input_Port_0,				//	IN,
 		Output_Port_0,				//	OUT
@@ -565,6 +1001,7 @@ public:
 		0xFF,	//	INT_MASK			** CANNOT BE USED **
 		0xFF,	//	INT_STATUS			** CANNOT BE USED **
 		0xFF,	//	OUTPUT_PORT_CONFIG	** CANNOT BE USED **
+		0xFF,	//	INT_EDGE			** CANNOT BE USED **
 	};
 
 #if DOXYGEN_ONLY
@@ -875,6 +1312,7 @@ public:
 		Interrupt_mask,					//	INT_MASK
 		Interrupt_status,				//	INT_STATUS
 		Output_port_configuration,		//	OUTPUT_PORT_CONFIG
+		0xFF,							//	INT_EDGE			** CANNOT BE USED **
 	};
 
 #if DOXYGEN_ONLY
@@ -1169,6 +1607,7 @@ public:
 		Interrupt_mask_register_0,				//	INT_MASK
 		Interrupt_status_register_0,			//	INT_STATUS
 		Output_port_configuration_register,		//	OUTPUT_PORT_CONFIG
+		0xFF,									//	INT_EDGE			** CANNOT BE USED **
 	};
 
 #if DOXYGEN_ONLY
@@ -1473,6 +1912,7 @@ public:
 		Interrupt_mask_register_port_0,					//	INT_MASK
 		Interrupt_status_register_port_0,				//	INT_STATUS
 		Output_port_configuration_register,				//	OUTPUT_PORT_CONFIG
+		Interrupt_edge_register_port_0A,				//	INT_EDGE
 	};
 
 #if DOXYGEN_ONLY
@@ -1780,6 +2220,7 @@ public:
 		Interrupt_mask_register_port_0,					//	INT_MASK
 		Interrupt_status_register_port_0,				//	INT_STATUS
 		Output_port_configuration_register,				//	OUTPUT_PORT_CONFIG
+		Interrupt_edge_register_port_0A,				//	INT_EDGE
 	};
 
 #if DOXYGEN_ONLY
@@ -2033,6 +2474,14 @@ public:
 	 */
 	GPIO_SPI( uint8_t device_address, int nbits, const uint8_t* arp, uint8_t ai );
 
+	/** Create a SPI device access with specified SPI instance and CS pin
+	 *
+	 * @param spi		SPI instance
+	 * @param cs_pin	Chip select pin
+	 * @param device_address device address
+	 */
+	GPIO_SPI( SPIClass& spi, int cs_pin, uint8_t device_address, int nbits, const uint8_t* arp, uint8_t ai );
+
 	/** Destructor of I2C_device
 	 */
 	virtual ~GPIO_SPI();
@@ -2072,6 +2521,143 @@ public:
 	 * @return read data size
 	 */
 	virtual uint8_t	reg_r( uint8_t reg_adr );
+
+	/** Write stream into single port
+	 * 
+	 *	Writes values into a register of single port repeatedly in one SPI frame
+	 *
+	 * @param w			Accsess word. This should be choosen from access_word'
+	 * @param vp		Pointer to an array of values
+	 * @param length	Number of values
+	 * @param port_num	Option, to specify port number
+	 */
+	virtual void		write_stream( access_word w, const uint8_t* vp, int length, int port_num = 0 );
+
+	/** Bus time estimation
+	 *
+	 *	Estimates time for one SPI frame which transfers 'n_bytes' of data
+	 *
+	 * @param n_bytes	Number of data bytes
+	 * @param clock		SPI clock frequency in Hz
+	 * @param read		'true' for read transaction
+	 * @return	Estimated time in microseconds
+	 */
+	virtual uint32_t	bus_time( int n_bytes, uint32_t clock, bool read = false );
+
+	/** I2C bus of the device
+	 *
+	 * @return	NULL
+	 */
+	virtual TwoWire*	wire( void );
+
+	/** SPI bus of the device
+	 *
+	 * @return	Pointer to SPIClass instance. SPI (default instance) if not given to constructor
+	 */
+	virtual SPIClass*	spi( void );
+
+	/** Maximum number of frames in a pipeline */
+	static constexpr int	PIPELINE_FRAMES	= 16;
+
+	/** Size of buffer for frames in a pipeline */
+	static constexpr int	PIPELINE_BUFFER	= 128;
+
+	/** Start pipelined mode
+	 * 
+	 *	Frames after this call are queued and issued back-to-back in one sequence by end_pipeline(). 
+	 *	A read issues the queued frames with the read frame at that point, since the caller 
+	 *	(like read_image(), write_pin2() or input()) uses the value on return. 
+	 *	Only read_port_deferred() keeps the read in the queue, to be stored at end_pipeline(). 
+	 *	The bus lock is held until end_pipeline(). 
+	 *
+	 *	last_status() of a queued write reports only queuing. Bus errors of queued frames are 
+	 *	reported by the read which issues them, or by end_pipeline(). 
+	 *
+	 *	Frames are issued in one SPI transaction if SPIClass is given to the constructor. 
+	 *	Without SPIClass (and without transport), frames are done one by one by I2C_device::txrx(), 
+	 *	so there is no saving in bus time. 
+	 */
+	void		begin_pipeline( void );
+
+	/** Issue queued frames and end pipelined mode
+	 * 
+	 * @return	Transferred data size. Negative value for error
+	 */
+	int			end_pipeline( void );
+
+	/** Deferred read of ports
+	 * 
+	 *	In pipelined mode, the read is queued and 'vp' is filled at end_pipeline(). 
+	 *	'vp' should be valid until then and should not be used before. 
+	 *	Out of pipelined mode, same as read_port( w, vp ). 
+	 *
+	 * @param w		Accsess word
+	 * @param vp	Pointer to an array to store read values. The array should have 'n_ports' length
+	 */
+	void		read_port_deferred( access_word w, uint8_t* vp );
+
+	/** Write ports and read ports in one frame sequence
+	 * 
+	 *	Typical use is output write followed by input read in a control loop
+	 *
+	 * @param w_out	Accsess word for write
+	 * @param out	Pointer to an array of values to write. The array should have 'n_ports' length
+	 * @param w_in	Accsess word for read
+	 * @param in	Pointer to an array to store read values. The array should have 'n_ports' length
+	 */
+	void		write_read_port( access_word w_out, const uint8_t* out, access_word w_in, uint8_t* in );
+
+	/** Join bus group
+	 * 
+	 *	Devices on a shared CS are distinguished by device address byte in the frame. 
+	 *	While the leader is in pipelined mode, frames of group members are queued into the leader's pipeline 
+	 *	and issued back-to-back in one sequence. The member shares the bus lock of the leader. 
+	 *
+	 * @param leader_dev	Device which leads the group
+	 */
+	void		group( GPIO_SPI& leader_dev );
+
+protected:
+	/** SPI instance. NULL to use I2C_device::txrx() */
+	SPIClass*	spip;
+
+	/** Chip select pin. -1 if not given */
+	int			cs;
+
+	/** Issue a frame, or queue it in pipelined mode
+	 *
+	 * @return	Frame size. Negative value for error
+	 */
+	int		frame( uint8_t* w_data, uint8_t* r_data, int size, uint8_t* dest = NULL );
+
+	virtual int	raw_w( uint8_t reg_adr, const uint8_t* data, uint16_t size );
+	virtual int	raw_r( uint8_t reg_adr, uint8_t* data, uint16_t size );
+
+	/** Issue a sequence of frames
+	 * 
+	 *	Frames are concatenated in the buffers
+	 *
+	 * @param w_data	Pointer to data to be sent
+	 * @param r_data	Pointer to buffer for received data
+	 * @param sizes		Array of frame sizes
+	 * @param n			Number of frames
+	 * @return	Transferred data size. Negative value for error
+	 */
+	virtual int	sequence( uint8_t* w_data, uint8_t* r_data, const uint16_t* sizes, int n );
+
+private:
+	GPIO_SPI*	leader;
+	bool		pipelining;
+	bool		deferring;
+	uint8_t		pl_w[ PIPELINE_BUFFER ];
+	uint8_t		pl_r[ PIPELINE_BUFFER ];
+	uint16_t	pl_size[ PIPELINE_FRAMES ];
+	uint8_t*	pl_dest[ PIPELINE_FRAMES ];
+	int			pl_frames;
+	int			pl_bytes;
+
+	int			flush_pipeline( void );
+	bool		enqueue( const uint8_t* w_data, int size, uint8_t* dest );
 };
 
 /** PCAL97xx_base class
@@ -2085,6 +2671,7 @@ class PCAL97xx_base : public GPIO_SPI
 {
 public:
 	PCAL97xx_base( uint8_t dev_address, const int nbits, const uint8_t arp[], uint8_t ai );
+	PCAL97xx_base( SPIClass& spi, int cs_pin, uint8_t dev_address, const int nbits, const uint8_t arp[], uint8_t ai );
 	virtual ~PCAL97xx_base();
 };
 
@@ -2128,6 +2715,18 @@ public:
 	 */
 	PCAL9722( uint8_t dev_address = (0x40 >> 1) + 0 );
 
+	/** Constractor
+	 * 
+	 *	For several devices on a bus. 
+	 *	Devices can share a CS pin if they have different device addresses (see group())
+	 *
+	 * @param spi			SPI instance
+	 * @param cs_pin		Chip select pin
+	 * @param reset_pin		RESET pin. -1 if not connected
+	 * @param dev_address	Device address
+	 */
+	PCAL9722( SPIClass& spi, int cs_pin, int reset_pin = -1, uint8_t dev_address = (0x40 >> 1) + 0 );
+
 	/** Destractor */
 	virtual ~PCAL9722();
 
@@ -2137,6 +2736,7 @@ public:
 	 * This method takes one argument of "PCAL6534::ARDUINO_SHIELD" to set RESET and ADDRESS pins. 
 	 * 
 	 * If the devoce is used as it self, this method doesn't need to be called. 
+	 * When the device has a CS pin or a RESET pin given to constructor, this method should be called to set them up. 
 	 *	
 	 * @param env	This argument can be given as "PCAL6534::NONE" ot "PCAL6534::ARDUINO_SHIELD"
 	 */
@@ -2154,10 +2754,12 @@ public:
 		Interrupt_mask_register_port_0,					//	INT_MASK
 		Interrupt_status_register_port_0,				//	INT_STATUS
 		Output_port_configuration_register,				//	OUTPUT_PORT_CONFIG
+		Interrupt_edge_register_port_0A,				//	INT_EDGE
 	};
 
 private:
 	static constexpr int RESET_PIN_PCAL9722	= 6;
+	int		rst_pin;
 
 public:	
 #if DOXYGEN_ONLY
@@ -0,0 +1,94 @@
+/** GPIO_TRANSPORT: bus transport interface for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_GPIO_TRANSPORT_H
+#define ARDUINO_GPIO_NXP_ARD_GPIO_TRANSPORT_H
+
+#include <stdint.h>
+
+/** GPIO_TRANSPORT class
+ *	
+ *  @class GPIO_TRANSPORT
+ *
+ *	Interface to replace bus access of GPIO devices. 
+ *	When a transport is set by GPIO_base::transport(), all register accesses of the device go through it
+ *	instead of I2C_device (Wire) or SPI. 
+ *
+ *	I2C devices use reg_w()/reg_r(). SPI devices (GPIO_SPI) use txrx() with their own frame format. 
+ *	A transport can return NOT_HANDLED to leave an access to the default path. 
+ */
+class GPIO_TRANSPORT {
+public:
+	/** Return value to let the device do the access by its default path (I2C_device or SPI) */
+	static constexpr int	NOT_HANDLED	= -2;
+
+	virtual ~GPIO_TRANSPORT() {}
+
+	/** Register write
+	 * 
+	 * @param address	Target address
+	 * @param reg		Register address (with auto-increment flag if needed)
+	 * @param data		Pointer to data
+	 * @param size		Data size
+	 * @return	Transferred data size. Negative value for error
+	 */
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )	= 0;
+
+	/** Register read
+	 * 
+	 *	Register address write and data read should be done in a transaction with repeated-START
+	 *
+	 * @param address	Target address
+	 * @param reg		Register address (with auto-increment flag if needed)
+	 * @param data		Pointer to data buffer
+	 * @param size		Data size
+	 * @return	Transferred data size. Negative value for error
+	 */
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )	= 0;
+
+	/** Full-duplex transfer (for SPI)
+	 * 
+	 * @param w_data	Pointer to data to be sent
+	 * @param r_data	Pointer to buffer for received data
+	 * @param size		Data size
+	 * @return	Transferred data size. Negative value for error
+	 */
+	virtual int	txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+	{
+		(void)w_data;
+		(void)r_data;
+		(void)size;
+		return -1;
+	}
+
+	/** Sequence of full-duplex frames (for SPI)
+	 * 
+	 *	Frames are concatenated in the buffers. CS is deasserted between frames. 
+	 *	Default implementation calls txrx() for each frame. 
+	 *
+	 * @param w_data	Pointer to data to be sent
+	 * @param r_data	Pointer to buffer for received data
+	 * @param sizes		Array of frame sizes
+	 * @param n			Number of frames
+	 * @return	Transferred data size. Negative value for error
+	 */
+	virtual int	txrx_sequence( const uint8_t* w_data, uint8_t* r_data, const uint16_t* sizes, int n )
+	{
+		int	total	= 0;
+
+		for ( int i = 0; i < n; i++ ) {
+			if ( txrx( w_data + total, r_data + total, sizes[ i ] ) < 0 )
+				return -1;
+
+			total	+= sizes[ i ];
+		}
+
+		return total;
+	}
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_GPIO_TRANSPORT_H
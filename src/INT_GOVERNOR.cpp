@@ -0,0 +1,147 @@
+#include "INT_GOVERNOR.h"
+#include "INT_LATENCY.h"
+
+INT_GOVERNOR::INT_GOVERNOR( GPIO_base& gpio, uint8_t limit, uint32_t window, uint32_t quiet, uint32_t holdoff )
+	: dev( gpio ), lim( (limit < 1) ? 1 : (MAX_LIMIT < limit) ? MAX_LIMIT : limit ),
+	window_length( window ), quiet_length( quiet ), holdoff_length( holdoff ),
+	pins( 0 ), int_mask( ~0ULL ), gov_mask( 0 ), last( 0 ), activity( 0 ),
+	pending( false ), n_interrupts( 0 ), n_passes( 0 ), n_suppressed( 0 ),
+	pass_time( 0 ), window_start( 0 ), quiet_start( 0 )
+{
+	for ( int i = 0; i < 4; i++ )
+		plane[ i ]	= 0;
+}
+
+void INT_GOVERNOR::begin( uint64_t governed_pins )
+{
+	pins		= governed_pins;
+	gov_mask	= 0;
+	int_mask	= dev.read_image( INT_MASK ) & ~pins;
+
+	dev.write_image( INT_MASK, int_mask );
+	last	= dev.read_image( IN );
+
+	window_start	= micros();
+	pass_time		= window_start - holdoff_length;
+
+	INT_LATENCY_ADD( &dev );
+}
+
+void INT_GOVERNOR::interrupt( void )
+{
+	pending	= true;
+	n_interrupts++;
+}
+
+uint64_t INT_GOVERNOR::service( void )
+{
+	uint32_t	now		= micros();
+	uint64_t	status	= 0;
+
+	if ( pending && (holdoff_length <= now - pass_time) ) {
+		pending		= false;
+		pass_time	= now;
+		n_passes++;
+
+		BUS_LOCK::guard	g( dev.bus_lock() );	//	INT_STATUS and IN are read in one lock
+
+		INT_LATENCY_READ_START( &dev );
+		status	= dev.read_image( INT_STATUS ) & pins;
+		last	= dev.read_image( IN );
+		INT_LATENCY_READ_END( &dev );
+
+		uint64_t	over	= count( status ) & ~gov_mask;
+
+		if ( over ) {
+			//	All offending pins are masked in one write. 
+			//	Quiet period is shared by masked pins: pins masked in a running period are taken as 
+			//	active in it, so that they wait a full period before unmasking
+			if ( !gov_mask )
+				quiet_start	= now;
+			else
+				activity	|= over;
+
+			gov_mask	|= over;
+			dev.write_image( INT_MASK, int_mask | gov_mask );
+		}
+
+		if ( status )
+			INT_LATENCY_DISPATCH( &dev );
+	}
+
+	if ( window_length <= now - window_start ) {
+		window_start	= now;
+
+		for ( int i = 0; i < 4; i++ )
+			plane[ i ]	= 0;
+
+		//	Masked pins are watched by one IN sample per window
+		if ( gov_mask ) {
+			uint64_t	v		= dev.read_image( IN );
+			uint64_t	change	= (v ^ last) & gov_mask;
+
+			n_suppressed	+= __builtin_popcountll( change );
+			activity		|= change;
+			last			= (last & ~gov_mask) | (v & gov_mask);
+		}
+	}
+
+	if ( gov_mask && (quiet_length <= now - quiet_start) ) {
+		uint64_t	calm	= gov_mask & ~activity;
+
+		quiet_start	= now;
+		activity	= 0;
+
+		if ( calm ) {
+			gov_mask	&= ~calm;
+			dev.write_image( INT_MASK, int_mask | gov_mask );
+		}
+	}
+
+	return status;
+}
+
+uint64_t INT_GOVERNOR::masked( void )
+{
+	return gov_mask;
+}
+
+uint64_t INT_GOVERNOR::levels( void )
+{
+	return last;
+}
+
+uint32_t INT_GOVERNOR::suppressed( void )
+{
+	return n_suppressed;
+}
+
+uint32_t INT_GOVERNOR::interrupts( void )
+{
+	return n_interrupts;
+}
+
+uint32_t INT_GOVERNOR::passes( void )
+{
+	return n_passes;
+}
+
+uint64_t INT_GOVERNOR::count( uint64_t status )
+{
+	//	Bit-sliced 4 bit counters: plane[ k ] holds bit 'k' of the counters of all pins
+	uint64_t	carry	= status;
+	uint64_t	reach	= status;
+
+	for ( int k = 0; k < 4; k++ ) {
+		uint64_t	t	= plane[ k ] & carry;
+
+		plane[ k ]	^= carry;
+		carry		= t;
+	}
+
+	//	Pins whose counter became equal to the limit
+	for ( int k = 0; k < 4; k++ )
+		reach	&= ((lim >> k) & 0x1) ? plane[ k ] : ~plane[ k ];
+
+	return reach;
+}
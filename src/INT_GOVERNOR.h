@@ -0,0 +1,126 @@
+/** INT_GOVERNOR: interrupt storm governor for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_INT_GOVERNOR_H
+#define ARDUINO_GPIO_NXP_ARD_INT_GOVERNOR_H
+
+#include <GPIO_NXP.h>
+
+/** INT_GOVERNOR class
+ *
+ *  @class INT_GOVERNOR
+ *
+ *	Limits interrupt load from chattering inputs of a GPIO device which has INT_MASK.
+ *
+ *	Interrupts are coalesced: interrupt() from ISR only sets a flag and service() reads INT_STATUS and IN 
+ *	at most once per 'holdoff' time. 
+ *	Interrupts of each pin are counted in bit-sliced counters over 'window' time. 
+ *	Pins which reach 'limit' in a window are masked by one INT_MASK write. 
+ *	While pins are masked, IN is sampled once per window and changes on the masked pins are counted as suppressed events. 
+ *	Masked pins are unmasked when no change is seen on them for 'quiet' time. 
+ *	Quiet periods are common to all masked pins, so a pin masked in a running period stays masked 
+ *	for 'quiet' to 2 x 'quiet' time.
+ *
+ *	Bus load is bounded to one service pass per 'holdoff' and one IN sample per 'window'.
+ */
+class INT_GOVERNOR {
+public:
+	/** Maximum limit of interrupts per window */
+	static constexpr int	MAX_LIMIT	= 15;
+
+	/** Constractor
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param limit		Number of interrupts in a window to mask a pin. 1 ~ MAX_LIMIT
+	 * @param window	Window length in microseconds
+	 * @param quiet		Quiet time to unmask pins in microseconds
+	 * @param holdoff	Minimum interval of service passes in microseconds
+	 */
+	INT_GOVERNOR( GPIO_base& gpio, uint8_t limit = 8, uint32_t window = 10000, uint32_t quiet = 100000, uint32_t holdoff = 1000 );
+
+	/** Start
+	 *
+	 *	Interrupts of the pins are unmasked
+	 *
+	 * @param pins	Bit image of pins to be governed
+	 */
+	void		begin( uint64_t pins );
+
+	/** Interrupt notification
+	 *
+	 *	Can be called from ISR
+	 */
+	void		interrupt( void );
+
+	/** Service routine
+	 *
+	 *	Does a service pass if interrupt is pending and holdoff time passed, 
+	 *	then masks and unmasks pins. Should be called frequently
+	 *
+	 * @return	Bit image of pins which caused interrupt in this pass. '0' if no pass was done
+	 */
+	uint64_t	service( void );
+
+	/** Masked pins
+	 *
+	 * @return	Bit image of pins masked by the governor
+	 */
+	uint64_t	masked( void );
+
+	/** Input levels
+	 *
+	 * @return	Last read IN image
+	 */
+	uint64_t	levels( void );
+
+	/** Suppressed events
+	 *
+	 *	Changes between IN samples are not seen, so this is a lower bound of suppressed interrupts
+	 *
+	 * @return	Number of changes seen on masked pins
+	 */
+	uint32_t	suppressed( void );
+
+	/** Number of interrupts
+	 *
+	 * @return	Number of interrupt() calls
+	 */
+	uint32_t	interrupts( void );
+
+	/** Number of service passes
+	 *
+	 * @return	Number of service passes
+	 */
+	uint32_t	passes( void );
+
+private:
+	GPIO_base&		dev;
+	uint8_t			lim;
+	uint32_t		window_length;
+	uint32_t		quiet_length;
+	uint32_t		holdoff_length;
+
+	uint64_t		pins;
+	uint64_t		int_mask;
+	uint64_t		gov_mask;
+	uint64_t		last;
+	uint64_t		plane[ 4 ];
+	uint64_t		activity;
+
+	volatile bool		pending;
+	volatile uint32_t	n_interrupts;
+	uint32_t		n_passes;
+	uint32_t		n_suppressed;
+
+	uint32_t		pass_time;
+	uint32_t		window_start;
+	uint32_t		quiet_start;
+
+	uint64_t	count( uint64_t status );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_INT_GOVERNOR_H
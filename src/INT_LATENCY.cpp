@@ -0,0 +1,155 @@
+#include "INT_LATENCY.h"
+
+#if defined( GPIO_NXP_INT_LATENCY )
+
+volatile uint32_t		INT_LATENCY::t_isr		= 0;
+volatile uint16_t		INT_LATENCY::n_isr		= 0;
+INT_LATENCY::record		INT_LATENCY::records[ MAX_DEVICES ];
+int						INT_LATENCY::n_records	= 0;
+
+bool INT_LATENCY::add( GPIO_base* dev )
+{
+	if ( find( dev ) )
+		return true;
+
+	if ( MAX_DEVICES <= n_records )
+		return false;
+
+	record*	rp	= records + n_records;
+
+	rp->dev			= dev;
+	rp->t_isr		= 0;
+	rp->t_start		= 0;
+	rp->t_end		= 0;
+	rp->seq			= 0;
+	rp->last_seq	= 0;
+	memset( rp->hist, 0, sizeof( rp->hist ) );
+
+	n_records++;
+
+	return true;
+}
+
+void INT_LATENCY::isr( void )
+{
+	t_isr	= micros();
+	n_isr++;
+}
+
+void INT_LATENCY::read_start( GPIO_base* dev )
+{
+	record*	rp	= find( dev );
+
+	if ( !rp )
+		return;
+
+	noInterrupts();
+	rp->t_isr	= t_isr;
+	rp->seq		= n_isr;
+	interrupts();
+
+	rp->t_start	= micros();
+}
+
+void INT_LATENCY::read_end( GPIO_base* dev )
+{
+	record*	rp	= find( dev );
+
+	if ( rp )
+		rp->t_end	= micros();
+}
+
+void INT_LATENCY::dispatch( GPIO_base* dev )
+{
+	uint32_t	now	= micros();
+	record*		rp	= find( dev );
+
+	if ( !rp )
+		return;
+
+	accumulate( rp, READ, rp->t_end - rp->t_start );
+	accumulate( rp, TO_DISPATCH, now - rp->t_end );
+
+	//	ISR stages are taken only when an ISR entry came after last dispatch
+	if ( rp->seq != rp->last_seq ) {
+		accumulate( rp, ISR_TO_READ, rp->t_start - rp->t_isr );
+		accumulate( rp, TOTAL, now - rp->t_isr );
+		rp->last_seq	= rp->seq;
+	}
+}
+
+const uint16_t* INT_LATENCY::histogram( GPIO_base* dev, stage s )
+{
+	for ( int i = 0; i < n_records; i++ )
+		if ( records[ i ].dev == dev )
+			return records[ i ].hist[ s ];
+
+	return NULL;
+}
+
+uint32_t INT_LATENCY::percentile( GPIO_base* dev, stage s, float p )
+{
+	const uint16_t*	h		= histogram( dev, s );
+	uint32_t		total	= 0;
+	uint32_t		sum		= 0;
+
+	if ( !h )
+		return 0;
+
+	for ( int i = 0; i < BINS; i++ )
+		total	+= h[ i ];
+
+	for ( int i = 0; i < BINS; i++ ) {
+		sum	+= h[ i ];
+
+		if ( total && (p * total <= 100.0 * sum) )
+			return (1UL << i) - 1;
+	}
+
+	return (1UL << (BINS - 1)) - 1;
+}
+
+void INT_LATENCY::export_csv( Print& out )
+{
+	for ( int i = 0; i < n_records; i++ ) {
+		for ( int s = 0; s < NUM_stage; s++ ) {
+			out.print( i );
+			out.print( "," );
+			out.print( s );
+
+			for ( int b = 0; b < BINS; b++ ) {
+				out.print( "," );
+				out.print( records[ i ].hist[ s ][ b ] );
+			}
+
+			out.println();
+		}
+	}
+}
+
+void INT_LATENCY::reset( void )
+{
+	for ( int i = 0; i < n_records; i++ )
+		memset( records[ i ].hist, 0, sizeof( records[ i ].hist ) );
+}
+
+INT_LATENCY::record* INT_LATENCY::find( GPIO_base* dev )
+{
+	for ( int i = 0; i < n_records; i++ )
+		if ( records[ i ].dev == dev )
+			return records + i;
+
+	return NULL;
+}
+
+void INT_LATENCY::accumulate( record* rp, stage s, uint32_t t )
+{
+	int	bin	= t ? (int)sizeof( unsigned long ) * 8 - __builtin_clzl( t ) : 0;
+
+	bin	= (BINS - 1 < bin) ? BINS - 1 : bin;
+
+	if ( rp->hist[ s ][ bin ] < 0xFFFF )
+		rp->hist[ s ][ bin ]++;
+}
+
+#endif	//	GPIO_NXP_INT_LATENCY
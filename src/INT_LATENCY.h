@@ -0,0 +1,150 @@
+/** INT_LATENCY: interrupt latency instrumentation for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_INT_LATENCY_H
+#define ARDUINO_GPIO_NXP_ARD_INT_LATENCY_H
+
+#include <GPIO_NXP.h>
+#include <Print.h>
+#include "INT_RESOLVER.h"
+
+/** Interrupt latency instrumentation
+ *
+ *	Enabled by defining GPIO_NXP_INT_LATENCY in build flags (e.g. -DGPIO_NXP_INT_LATENCY). 
+ *	When it is not defined, the INT_LATENCY_* macros are empty and INT_LATENCY class doesn't exist.
+ */
+#if defined( GPIO_NXP_INT_LATENCY )
+
+#define	INT_LATENCY_ADD( dev )			INT_LATENCY::add( dev )
+#define	INT_LATENCY_ISR()				INT_LATENCY::isr()
+#define	INT_LATENCY_READ_START( dev )	INT_LATENCY::read_start( dev )
+#define	INT_LATENCY_READ_END( dev )		INT_LATENCY::read_end( dev )
+#define	INT_LATENCY_DISPATCH( dev )		INT_LATENCY::dispatch( dev )
+
+/** INT_LATENCY class
+ *
+ *  @class INT_LATENCY
+ *
+ *	Takes time stamps at ISR entry, start and end of INT_STATUS/IN read and callback dispatch, 
+ *	and accumulates the intervals into histograms per device. 
+ *	Bin 'n' counts intervals of 2^(n-1) ~ 2^n - 1 microseconds (bin 0 is 0us). Last bin includes longer intervals.
+ *
+ *	INT_LATENCY_ISR() should be put in the ISR of the INT pin. 
+ *	INT_RESOLVER, INT_GOVERNOR, QUAD_ENCODER and PULSE_COUNTER register their devices in begin() and 
+ *	take other time stamps in their service routines. Records are made at registration, so no 
+ *	record is searched for a free slot or initialized inside measured intervals. 
+ *	ISR_TO_READ and TOTAL are taken only for the first service of a device after an ISR entry, 
+ *	so services by polling don't count in them.
+ */
+class INT_LATENCY {
+public:
+	/** Maximum number of devices. Same as INT_RESOLVER, so that all devices on a shared INT line can be measured */
+	static constexpr int	MAX_DEVICES	= INT_RESOLVER::MAX_DEVICES;
+
+	/** Number of histogram bins */
+	static constexpr int	BINS		= 16;
+
+	/** Measured intervals */
+	enum stage {
+		ISR_TO_READ,	/**< ISR entry to start of read */
+		READ,			/**< Start to end of read */
+		TO_DISPATCH,	/**< End of read to callback dispatch */
+		TOTAL,			/**< ISR entry to callback dispatch */
+		NUM_stage,
+	};
+
+	/** Register a device
+	 *
+	 *	Time stamps of devices which are not registered are ignored
+	 *
+	 * @param dev	GPIO device instance
+	 * @return	'false' if MAX_DEVICES are already registered
+	 */
+	static bool		add( GPIO_base* dev );
+
+	/** Time stamp at ISR entry */
+	static void		isr( void );
+
+	/** Time stamp at start of read
+	 *
+	 * @param dev	GPIO device instance
+	 */
+	static void		read_start( GPIO_base* dev );
+
+	/** Time stamp at end of read
+	 *
+	 * @param dev	GPIO device instance
+	 */
+	static void		read_end( GPIO_base* dev );
+
+	/** Time stamp at callback dispatch
+	 *
+	 *	Intervals are added into histograms
+	 *
+	 * @param dev	GPIO device instance
+	 */
+	static void		dispatch( GPIO_base* dev );
+
+	/** Histogram
+	 *
+	 * @param dev	GPIO device instance
+	 * @param s		Stage
+	 * @return	Pointer to array of BINS counts. 'NULL' if the device has no record
+	 */
+	static const uint16_t*	histogram( GPIO_base* dev, stage s );
+
+	/** Percentile
+	 *
+	 * @param dev	GPIO device instance
+	 * @param s		Stage
+	 * @param p		Percentile. 0.0 ~ 100.0
+	 * @return	Upper bound of the bin in microseconds
+	 */
+	static uint32_t	percentile( GPIO_base* dev, stage s, float p );
+
+	/** Export histograms
+	 *
+	 *	One line per device and stage: device index, stage and counts of all bins in comma separated values
+	 *
+	 * @param out	Output stream like Serial
+	 */
+	static void		export_csv( Print& out );
+
+	/** Clear all histograms */
+	static void		reset( void );
+
+private:
+	struct record {
+		GPIO_base*	dev;
+		uint32_t	t_isr;
+		uint32_t	t_start;
+		uint32_t	t_end;
+		uint16_t	seq;
+		uint16_t	last_seq;
+		uint16_t	hist[ NUM_stage ][ BINS ];
+	};
+
+	static volatile uint32_t	t_isr;
+	static volatile uint16_t	n_isr;
+	static record				records[ MAX_DEVICES ];
+	static int					n_records;
+
+	static record*	find( GPIO_base* dev );
+	static void		accumulate( record* rp, stage s, uint32_t t );
+};
+
+#else
+
+#define	INT_LATENCY_ADD( dev )			((void)0)
+#define	INT_LATENCY_ISR()				((void)0)
+#define	INT_LATENCY_READ_START( dev )	((void)0)
+#define	INT_LATENCY_READ_END( dev )		((void)0)
+#define	INT_LATENCY_DISPATCH( dev )		((void)0)
+
+#endif	//	GPIO_NXP_INT_LATENCY
+
+#endif //	ARDUINO_GPIO_NXP_ARD_INT_LATENCY_H
@@ -0,0 +1,179 @@
+#include "INT_RESOLVER.h"
+#include "INT_LATENCY.h"
+
+INT_RESOLVER::INT_RESOLVER( int int_pin )
+	: pin( int_pin ), n_devs( 0 ), n_polls( 0 )
+{
+}
+
+bool INT_RESOLVER::add( GPIO_base& gpio, uint8_t priority, callback_t callback )
+{
+	if ( MAX_DEVICES <= n_devs )
+		return false;
+
+	//	Insertion keeps priority order. Same priority devices stay in order of addition
+	int	i	= n_devs++;
+
+	for ( ; i && (devs[ i - 1 ].priority < priority); i-- )
+		devs[ i ]	= devs[ i - 1 ];
+
+	devs[ i ].dev		= &gpio;
+	devs[ i ].priority	= priority;
+	devs[ i ].callback	= callback;
+	devs[ i ].int_mask	= ~0ULL;
+	devs[ i ].sources	= 0;
+	devs[ i ].last		= 0;
+	devs[ i ].status	= 0;
+	devs[ i ].first		= 0;
+	devs[ i ].n			= 0;
+
+	return true;
+}
+
+void INT_RESOLVER::begin( void )
+{
+	if ( 0 <= pin )
+		pinMode( pin, INPUT_PULLUP );
+
+	for ( int i = 0; i < n_devs; i++ ) {
+		device*	dp	= devs + i;
+
+		dp->int_mask	= dp->dev->has_register( INT_MASK ) ? dp->dev->read_image( INT_MASK ) : 0;
+		dp->last		= dp->dev->read_image( IN );
+
+		sources( dp );
+		INT_LATENCY_ADD( dp->dev );
+	}
+}
+
+void INT_RESOLVER::update( GPIO_base& gpio )
+{
+	device*	dp	= find( &gpio );
+
+	if ( !dp )
+		return;
+
+	dp->int_mask	= gpio.has_register( INT_MASK ) ? gpio.read_image( INT_MASK ) : 0;
+	sources( dp );
+}
+
+bool INT_RESOLVER::mask( GPIO_base& gpio, uint64_t pins, bool masked )
+{
+	device*	dp	= find( &gpio );
+
+	if ( !dp || !gpio.has_register( INT_MASK ) )
+		return false;
+
+	dp->int_mask	= masked ? (dp->int_mask | pins) : (dp->int_mask & ~pins);
+	gpio.write_image( INT_MASK, dp->int_mask );
+	sources( dp );
+
+	return true;
+}
+
+int INT_RESOLVER::service( void )
+{
+	int	n	= 0;
+
+	n_polls	= 0;
+
+	for ( int i = 0; i < n_devs; i++ ) {
+		device*	dp	= devs + i;
+
+		if ( !dp->sources )
+			continue;
+
+		if ( (0 <= pin) && digitalRead( pin ) )
+			break;
+
+		GPIO_base&	gpio	= *dp->dev;
+		uint8_t		b[ 8 ]	= { 0 };
+		uint64_t	range	= (~0ULL >> (64 - dp->n * 8)) << (dp->first * 8);
+		uint64_t	status;
+		uint64_t	levels;
+
+		n_polls++;
+		INT_LATENCY_READ_START( &gpio );
+
+		{
+			//	INT_STATUS and IN are read in one lock but in two transactions, since they are not adjacent
+			BUS_LOCK::guard	g( gpio.bus_lock() );
+
+			if ( gpio.has_register( INT_STATUS ) ) {
+				gpio.read_field( INT_STATUS, b + dp->first, dp->first, dp->n );
+				status	= gpio.pack( b ) & range;
+
+				gpio.read_field( IN, b + dp->first, dp->first, dp->n );
+				levels	= gpio.pack( b ) & range;
+				levels	|= dp->last & ~range;
+			}
+			else {
+				gpio.read_field( IN, b );
+				levels	= gpio.pack( b );
+				status	= (levels ^ dp->last) & dp->sources;
+			}
+		}
+
+		INT_LATENCY_READ_END( &gpio );
+
+		dp->last	= levels;
+		dp->status	= status;
+
+		if ( !status )
+			continue;
+
+		n++;
+		INT_LATENCY_DISPATCH( &gpio );
+
+		if ( dp->callback )
+			dp->callback( gpio, status, levels );
+	}
+
+	return n;
+}
+
+uint64_t INT_RESOLVER::status( GPIO_base& gpio )
+{
+	device*	dp	= find( &gpio );
+
+	return dp ? dp->status : 0;
+}
+
+uint64_t INT_RESOLVER::levels( GPIO_base& gpio )
+{
+	device*	dp	= find( &gpio );
+
+	return dp ? dp->last : 0;
+}
+
+int INT_RESOLVER::polls( void )
+{
+	return n_polls;
+}
+
+INT_RESOLVER::device* INT_RESOLVER::find( GPIO_base* gpio )
+{
+	for ( int i = 0; i < n_devs; i++ )
+		if ( devs[ i ].dev == gpio )
+			return devs + i;
+
+	return NULL;
+}
+
+void INT_RESOLVER::sources( device* dp )
+{
+	GPIO_base&	gpio	= *dp->dev;
+	uint64_t	valid	= (64 <= gpio.n_ports * 8) ? ~0ULL : (1ULL << (gpio.n_ports * 8)) - 1;
+
+	//	Input pins which are not masked can assert INT
+	dp->sources	= gpio.read_image( CONFIG ) & ~dp->int_mask & valid;
+
+	if ( !dp->sources ) {
+		dp->first	= 0;
+		dp->n		= 0;
+		return;
+	}
+
+	dp->first	= __builtin_ctzll( dp->sources ) / 8;
+	dp->n		= (63 - __builtin_clzll( dp->sources )) / 8 - dp->first + 1;
+}
@@ -0,0 +1,133 @@
+/** INT_RESOLVER: shared interrupt line resolver for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_INT_RESOLVER_H
+#define ARDUINO_GPIO_NXP_ARD_INT_RESOLVER_H
+
+#include <GPIO_NXP.h>
+
+/** INT_RESOLVER class
+ *
+ *  @class INT_RESOLVER
+ *
+ *	Finds and services interrupt sources on GPIO devices sharing one open-drain INT line.
+ *	Devices are polled in priority order and only devices which have unmasked input pins are polled.
+ *	Polling stops when the INT line is deasserted.
+ *
+ *	A device with INT_STATUS is serviced by reading INT_STATUS and IN of ports which have unmasked pins. 
+ *	Reading IN clears the interrupt of the device. 
+ *	These are two ranged reads (two bus transactions) in one bus lock, not one burst: 
+ *	INT_STATUS and IN are not adjacent in register maps of the PCAL devices, so a burst over both 
+ *	would transfer all registers between them. Input_status is not used since reading it doesn't clear 
+ *	the interrupt and an extra Interrupt_clear write would be needed. 
+ *	A device without INT_STATUS (PCA9554/PCA9555) is serviced by one IN read and changed pins are found 
+ *	by comparing with previous value.
+ *
+ *	service() should be called when the INT line is asserted.
+ */
+class INT_RESOLVER {
+public:
+	/** Maximum number of devices */
+	static constexpr int	MAX_DEVICES	= 8;
+
+	/** Callback type
+	 *
+	 *	'status' is bit image of pins which caused the interrupt and 'levels' is IN image of the device
+	 */
+	typedef void	(*callback_t)( GPIO_base& gpio, uint64_t status, uint64_t levels );
+
+	/** Constractor
+	 *
+	 * @param int_pin	Arduino pin number of the INT line (active LOW). Set -1 to poll all active devices
+	 */
+	INT_RESOLVER( int int_pin = -1 );
+
+	/** Add device
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param priority	Polling priority. Larger number is polled earlier
+	 * @param callback	Callback for serviced device. Can be 'NULL'
+	 * @return	'true' if added
+	 */
+	bool		add( GPIO_base& gpio, uint8_t priority = 0, callback_t callback = NULL );
+
+	/** Start
+	 *
+	 *	Reads interrupt masks, configurations and input values of all devices
+	 */
+	void		begin( void );
+
+	/** Update interrupt sources of a device
+	 *
+	 *	Should be called when INT_MASK or CONFIG of the device is changed without mask()
+	 *
+	 * @param gpio	GPIO device instance
+	 */
+	void		update( GPIO_base& gpio );
+
+	/** Mask or unmask interrupts
+	 *
+	 *	INT_MASK is changed in one write and interrupt sources are updated
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param pins		Bit image of pins
+	 * @param masked	'true' to mask, 'false' to unmask
+	 * @return	'false' if the device doesn't have INT_MASK
+	 */
+	bool		mask( GPIO_base& gpio, uint64_t pins, bool masked );
+
+	/** Service routine
+	 *
+	 *	Polls devices until the INT line is deasserted and calls callbacks of serviced devices
+	 *
+	 * @return	Number of devices which had interrupt
+	 */
+	int			service( void );
+
+	/** Interrupt status
+	 *
+	 * @param gpio	GPIO device instance
+	 * @return	Bit image of pins which caused interrupt in last service()
+	 */
+	uint64_t	status( GPIO_base& gpio );
+
+	/** Input levels
+	 *
+	 * @param gpio	GPIO device instance
+	 * @return	Last read IN image
+	 */
+	uint64_t	levels( GPIO_base& gpio );
+
+	/** Number of polls
+	 *
+	 * @return	Number of devices polled in last service()
+	 */
+	int			polls( void );
+
+private:
+	struct device {
+		GPIO_base*	dev;
+		uint8_t		priority;
+		callback_t	callback;
+		uint64_t	int_mask;
+		uint64_t	sources;
+		uint64_t	last;
+		uint64_t	status;
+		uint8_t		first;
+		uint8_t		n;
+	};
+
+	int			pin;
+	device		devs[ MAX_DEVICES ];
+	int			n_devs;
+	int			n_polls;
+
+	device*		find( GPIO_base* gpio );
+	void		sources( device* dp );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_INT_RESOLVER_H
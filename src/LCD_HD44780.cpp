@@ -0,0 +1,133 @@
+#include "LCD_HD44780.h"
+
+LCD_HD44780::LCD_HD44780( GPIO_base& gpio, int port_num, int rs, int rw, int e, int bl, int d4 )
+	: dev( gpio ), pn( port_num ), 
+	rs_bit( 1 << rs ), rw_bit( 1 << rw ), e_bit( 1 << e ), bl_bit( (bl < 0) ? 0 : 1 << bl ), d4_pos( d4 ), 
+	base( 0 ), n_rows( 2 ), n_hold( 0 ), n_buf( 0 ), rs_state( false )
+{
+}
+
+void LCD_HD44780::begin( int cols, int rows )
+{
+	(void)cols;
+	uint8_t	pins	= rs_bit | rw_bit | e_bit | bl_bit | (0x0F << d4_pos);
+
+	n_rows	= rows;
+	base	= (dev.read_port( OUT, pn ) & ~pins) | bl_bit;
+
+	dev.output( pn, base );
+	dev.config( pn, dev.read_port( CONFIG, pn ) & ~pins );
+
+	//	Initialization by instruction, 4-bit interface
+	delay( 50 );
+	nibble( 0x3, false );
+	flush();
+	delay( 5 );
+	nibble( 0x3, false );
+	flush();
+	delayMicroseconds( 150 );
+	nibble( 0x3, false );
+	nibble( 0x2, false );
+	flush();
+
+	command( (1 < rows) ? 0x28 : 0x20 );	//	function set: 4-bit, number of lines
+	command( 0x0C );						//	display on
+	clear();
+	command( 0x06 );						//	entry mode: increment
+}
+
+void LCD_HD44780::clear( void )
+{
+	command( 0x01 );
+	delay( 2 );	//	execution time = 1.52ms
+}
+
+void LCD_HD44780::home( void )
+{
+	command( 0x02 );
+	delay( 2 );	//	execution time = 1.52ms
+}
+
+void LCD_HD44780::set_cursor( int col, int row )
+{
+	static const uint8_t	offset[]	= { 0x00, 0x40, 0x14, 0x54 };
+
+	if ( n_rows <= row )
+		row	= n_rows - 1;
+
+	command( 0x80 | (offset[ row ] + col) );
+}
+
+void LCD_HD44780::backlight( bool on )
+{
+	base	= on ? (base | bl_bit) : (base & ~bl_bit);
+
+	put( base | (rs_state ? rs_bit : 0) );
+	flush();
+}
+
+void LCD_HD44780::command( uint8_t value )
+{
+	byte( value, false );
+	flush();
+}
+
+void LCD_HD44780::hold( int n )
+{
+	//	A character (up to 5 bytes) and its idle bytes should fit in one burst
+	n_hold	= (n < 0) ? 0 : ((BURST_LENGTH - 5 < n) ? BURST_LENGTH - 5 : n);
+}
+
+size_t LCD_HD44780::write( uint8_t value )
+{
+	return write( &value, 1 );
+}
+
+size_t LCD_HD44780::write( const uint8_t* buffer, size_t size )
+{
+	for ( size_t i = 0; i < size; i++ )
+		byte( buffer[ i ], true );
+
+	flush();
+	
+	return size;
+}
+
+void LCD_HD44780::nibble( uint8_t value, bool rs )
+{
+	uint8_t	v	= base | (rs ? rs_bit : 0) | ((value & 0x0F) << d4_pos);
+
+	//	RS should be settled before E rising edge
+	if ( rs != rs_state ) {
+		put( v );
+		rs_state	= rs;
+	}
+
+	put( v | e_bit );
+	put( v );
+}
+
+void LCD_HD44780::byte( uint8_t value, bool rs )
+{
+	if ( BURST_LENGTH < n_buf + 5 + n_hold )
+		flush();
+
+	nibble( value >> 4, rs );
+	nibble( value, rs );
+
+	for ( int i = 0; i < n_hold; i++ )
+		put( buf[ n_buf - 1 ] );
+}
+
+void LCD_HD44780::put( uint8_t value )
+{
+	buf[ n_buf++ ]	= value;
+}
+
+void LCD_HD44780::flush( void )
+{
+	if ( n_buf )
+		dev.write_stream( OUT, buf, n_buf, pn );
+
+	n_buf	= 0;
+}
@@ -0,0 +1,121 @@
+/** LCD_HD44780: HD44780 character LCD driver over GPIO port, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_LCD_HD44780_H
+#define ARDUINO_GPIO_NXP_ARD_LCD_HD44780_H
+
+#include <GPIO_NXP.h>
+#include <Print.h>
+
+/** LCD_HD44780 class
+ *
+ *  @class LCD_HD44780
+ *
+ *	HD44780 compatible character LCD in 4-bit mode, connected to a port of GPIO device.
+ *	Data nibbles with E strobes are packed into a buffer and sent by write_stream().
+ *	A character takes 4 bytes in one transaction instead of separated output() calls.
+ *
+ *	Default pin assignment is same as common PCF8574 LCD backpacks:
+ *	bit0=RS, bit1=RW, bit2=E, bit3=backlight, bit4~7=D4~D7
+ */
+class LCD_HD44780 : public Print {
+public:
+	/** Number of bytes in one burst */
+	static constexpr int	BURST_LENGTH	= 28;
+
+	/** Constractor
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param port_num	Port number
+	 * @param rs		RS pin bit position
+	 * @param rw		RW pin bit position. Fixed to LOW (write)
+	 * @param e			E pin bit position
+	 * @param bl		Backlight pin bit position. Set -1 if not used
+	 * @param d4		D4 pin bit position. D5~D7 should follow on upper bits
+	 */
+	LCD_HD44780( GPIO_base& gpio, int port_num = 0, int rs = 0, int rw = 1, int e = 2, int bl = 3, int d4 = 4 );
+
+	/** Initialize LCD
+	 *
+	 * @param cols	Number of columns
+	 * @param rows	Number of rows
+	 */
+	void	begin( int cols = 16, int rows = 2 );
+
+	/** Clear screen */
+	void	clear( void );
+
+	/** Cursor to home position */
+	void	home( void );
+
+	/** Set cursor position
+	 *
+	 * @param col	Column
+	 * @param row	Row
+	 */
+	void	set_cursor( int col, int row );
+
+	/** Backlight control
+	 *
+	 * @param on	'true' to turn on
+	 */
+	void	backlight( bool on );
+
+	/** Send command
+	 *
+	 * @param value	Command byte
+	 */
+	void	command( uint8_t value );
+
+	/** Hold time
+	 *
+	 *	Number of idle bytes inserted after each character/command.
+	 *	Needed when the bus is faster than execution time of the LCD (37us)
+	 *
+	 * @param n	Number of idle bytes. Limited to BURST_LENGTH - 5
+	 */
+	void	hold( int n );
+
+	/** Write a character (for Print class)
+	 *
+	 * @param value	Character
+	 * @return	1
+	 */
+	virtual size_t	write( uint8_t value );
+
+	/** Write characters in bursts (for Print class)
+	 *
+	 * @param buffer	Characters
+	 * @param size		Number of characters
+	 * @return	Number of characters written
+	 */
+	virtual size_t	write( const uint8_t* buffer, size_t size );
+
+	using Print::write;
+
+private:
+	GPIO_base&	dev;
+	int			pn;
+	uint8_t		rs_bit;
+	uint8_t		rw_bit;
+	uint8_t		e_bit;
+	uint8_t		bl_bit;
+	int			d4_pos;
+	uint8_t		base;
+	int			n_rows;
+	int			n_hold;
+	uint8_t		buf[ BURST_LENGTH ];
+	int			n_buf;
+	bool		rs_state;
+
+	void	nibble( uint8_t value, bool rs );
+	void	byte( uint8_t value, bool rs );
+	void	put( uint8_t value );
+	void	flush( void );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_LCD_HD44780_H
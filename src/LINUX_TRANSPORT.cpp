@@ -0,0 +1,278 @@
+#include "LINUX_TRANSPORT.h"
+
+#if defined( __linux__ ) && !defined( ARDUINO )
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+/* ******** LINUX_I2C ******** */
+
+LINUX_I2C::LINUX_I2C( const char* path )
+	: fd( open( path, O_RDWR ) ), own_fd( true ), batching( false ), n_msg( 0 ), n_buf( 0 )
+{
+}
+
+LINUX_I2C::LINUX_I2C( int file_descriptor )
+	: fd( file_descriptor ), own_fd( false ), batching( false ), n_msg( 0 ), n_buf( 0 )
+{
+}
+
+LINUX_I2C::~LINUX_I2C()
+{
+	if ( own_fd && (0 <= fd) )
+		close( fd );
+}
+
+bool LINUX_I2C::is_open( void )
+{
+	return 0 <= fd;
+}
+
+int LINUX_I2C::reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+{
+	if ( !batching ) {
+		uint8_t			b[ size + 1 ];
+		struct i2c_msg	m	= { address, 0, (uint16_t)(size + 1), b };
+
+		b[ 0 ]	= reg;
+		memcpy( b + 1, data, size );
+
+		return (transfer( &m, 1 ) < 0) ? -1 : size;
+	}
+
+	if ( ((MAX_MESSAGES < n_msg + 1) || (BATCH_BUFFER < n_buf + size + 1)) && (flush() < 0) )
+		return -1;
+
+	if ( BATCH_BUFFER < size + 1 )
+		return -1;
+
+	uint8_t*	bp	= buf + n_buf;
+
+	bp[ 0 ]	= reg;
+	memcpy( bp + 1, data, size );
+	n_buf	+= size + 1;
+
+	msg[ n_msg++ ]	= (struct i2c_msg){ address, 0, (uint16_t)(size + 1), bp };
+
+	return size;
+}
+
+int LINUX_I2C::reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+{
+	if ( !batching ) {
+		struct i2c_msg	m[ 2 ]	= {
+			{ address, 0,        1,    &reg },
+			{ address, I2C_M_RD, size, data },
+		};
+
+		return (transfer( m, 2 ) < 0) ? -1 : size;
+	}
+
+	if ( ((MAX_MESSAGES < n_msg + 2) || (BATCH_BUFFER < n_buf + 1)) && (flush() < 0) )
+		return -1;
+
+	uint8_t*	bp	= buf + n_buf++;
+
+	*bp	= reg;
+
+	msg[ n_msg++ ]	= (struct i2c_msg){ address, 0,        1,    bp   };
+	msg[ n_msg++ ]	= (struct i2c_msg){ address, I2C_M_RD, size, data };
+
+	//	Caller uses the data on return (like read-modify-write). 
+	//	Queued writes and this read are issued by one ioctl
+	return (flush() < 0) ? -1 : size;
+}
+
+void LINUX_I2C::begin_batch( void )
+{
+	batching	= true;
+	n_msg		= 0;
+	n_buf		= 0;
+}
+
+int LINUX_I2C::end_batch( void )
+{
+	int	r	= flush();
+
+	batching	= false;
+
+	return r;
+}
+
+int LINUX_I2C::transfer( struct i2c_msg* msgs, int n )
+{
+	struct i2c_rdwr_ioctl_data	data	= { msgs, (uint32_t)n };
+
+	return ioctl( fd, I2C_RDWR, &data );
+}
+
+int LINUX_I2C::flush( void )
+{
+	int	n	= n_msg;
+
+	if ( n && (transfer( msg, n ) < 0) )
+		n	= -1;
+
+	n_msg	= 0;
+	n_buf	= 0;
+
+	return n;
+}
+
+
+/* ******** LINUX_SPI ******** */
+
+LINUX_SPI::LINUX_SPI( const char* path, uint32_t speed, uint8_t mode )
+	: fd( open( path, O_RDWR ) ), own_fd( true ), hz( speed ), batching( false ), n_xfer( 0 ), n_buf( 0 )
+{
+	uint8_t	bits	= 8;
+
+	if ( 0 <= fd ) {
+		ioctl( fd, SPI_IOC_WR_MODE, &mode );
+		ioctl( fd, SPI_IOC_WR_BITS_PER_WORD, &bits );
+		ioctl( fd, SPI_IOC_WR_MAX_SPEED_HZ, &hz );
+	}
+}
+
+LINUX_SPI::LINUX_SPI( int file_descriptor, uint32_t speed )
+	: fd( file_descriptor ), own_fd( false ), hz( speed ), batching( false ), n_xfer( 0 ), n_buf( 0 )
+{
+}
+
+LINUX_SPI::~LINUX_SPI()
+{
+	if ( own_fd && (0 <= fd) )
+		close( fd );
+}
+
+bool LINUX_SPI::is_open( void )
+{
+	return 0 <= fd;
+}
+
+int LINUX_SPI::reg_w( uint8_t, uint8_t, const uint8_t*, uint16_t )
+{
+	return -1;
+}
+
+int LINUX_SPI::reg_r( uint8_t, uint8_t, uint8_t*, uint16_t )
+{
+	return -1;
+}
+
+int LINUX_SPI::txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+{
+	struct spi_ioc_transfer	t;
+
+	memset( &t, 0, sizeof( t ) );
+	t.len			= size;
+	t.speed_hz		= hz;
+	t.bits_per_word	= 8;
+
+	if ( !batching ) {
+		t.tx_buf	= (uintptr_t)w_data;
+		t.rx_buf	= (uintptr_t)r_data;
+
+		return (transfer( &t, 1 ) < 0) ? -1 : size;
+	}
+
+	if ( ((MAX_MESSAGES < n_xfer + 1) || (BATCH_BUFFER < n_buf + size)) && (flush() < 0) )
+		return -1;
+
+	if ( BATCH_BUFFER < size )
+		return -1;
+
+	memcpy( buf + n_buf, w_data, size );
+	t.tx_buf	= (uintptr_t)(buf + n_buf);
+	t.cs_change	= 1;	//	CS is deasserted after this frame
+	n_buf		+= size;
+
+	//	Read frame (R/W bit in GPIO_SPI frame format) is issued with queued frames 
+	//	because caller uses received data on return
+	if ( (w_data[ 0 ] & 0x01) && r_data ) {
+		t.rx_buf			= (uintptr_t)r_data;
+		xfer[ n_xfer++ ]	= t;
+
+		return (flush() < 0) ? -1 : size;
+	}
+
+	xfer[ n_xfer++ ]	= t;
+
+	return size;
+}
+
+int LINUX_SPI::txrx_sequence( const uint8_t* w_data, uint8_t* r_data, const uint16_t* sizes, int n )
+{
+	struct spi_ioc_transfer	t[ MAX_MESSAGES ];
+	int						total	= 0;
+
+	if ( batching && (flush() < 0) )
+		return -1;
+
+	while ( n ) {
+		int	n_frames	= (MAX_MESSAGES < n) ? MAX_MESSAGES : n;
+
+		memset( t, 0, sizeof( t[ 0 ] ) * n_frames );
+
+		for ( int i = 0; i < n_frames; i++ ) {
+			t[ i ].tx_buf			= (uintptr_t)(w_data + total);
+			t[ i ].rx_buf			= (uintptr_t)(r_data + total);
+			t[ i ].len				= sizes[ i ];
+			t[ i ].speed_hz			= hz;
+			t[ i ].bits_per_word	= 8;
+			t[ i ].cs_change		= (i < n_frames - 1) ? 1 : 0;
+
+			total	+= sizes[ i ];
+		}
+
+		if ( transfer( t, n_frames ) < 0 )
+			return -1;
+
+		sizes	+= n_frames;
+		n		-= n_frames;
+	}
+
+	return total;
+}
+
+void LINUX_SPI::begin_batch( void )
+{
+	batching	= true;
+	n_xfer		= 0;
+	n_buf		= 0;
+}
+
+int LINUX_SPI::end_batch( void )
+{
+	int	r	= flush();
+
+	batching	= false;
+
+	return r;
+}
+
+int LINUX_SPI::transfer( struct spi_ioc_transfer* t, int n )
+{
+	return ioctl( fd, SPI_IOC_MESSAGE( n ), t );
+}
+
+int LINUX_SPI::flush( void )
+{
+	int	n	= n_xfer;
+
+	if ( n ) {
+		xfer[ n - 1 ].cs_change	= 0;	//	CS is deasserted at end of message anyway
+
+		if ( transfer( xfer, n ) < 0 )
+			n	= -1;
+	}
+
+	n_xfer	= 0;
+	n_buf	= 0;
+
+	return n;
+}
+
+#endif	//	__linux__ && !ARDUINO
@@ -0,0 +1,189 @@
+/** LINUX_TRANSPORT: Linux userspace transport (i2c-dev and spidev) for GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_LINUX_TRANSPORT_H
+#define ARDUINO_GPIO_NXP_ARD_LINUX_TRANSPORT_H
+
+#if defined( __linux__ ) && !defined( ARDUINO )
+
+#include <stdint.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <linux/spi/spidev.h>
+
+#include "GPIO_TRANSPORT.h"
+
+/** LINUX_I2C class
+ *	
+ *  @class LINUX_I2C
+ *
+ *	Transport on /dev/i2c-N. 
+ *	Each register access is done by one I2C_RDWR ioctl. 
+ *	Register read is a combined write+read message pair (repeated-START). 
+ *
+ *	Between begin_batch() and end_batch(), writes are queued and issued by one ioctl. 
+ *	A read is issued together with queued writes, so its data is available on return. 
+ */
+class LINUX_I2C : public GPIO_TRANSPORT {
+public:
+	/** Maximum number of messages in one ioctl */
+	static constexpr int	MAX_MESSAGES	= I2C_RDWR_IOCTL_MAX_MSGS;
+
+	/** Size of buffer for write data in a batch */
+	static constexpr int	BATCH_BUFFER	= 512;
+
+	/** Constractor
+	 * 
+	 * @param path	Device node path like "/dev/i2c-1"
+	 */
+	LINUX_I2C( const char* path );
+
+	/** Constractor
+	 * 
+	 * @param fd	File descriptor already opened. It is not closed by this class
+	 */
+	LINUX_I2C( int fd );
+
+	/** Destractor */
+	virtual ~LINUX_I2C();
+
+	/** Check device node
+	 * 
+	 * @return	'true' if the device node is open
+	 */
+	bool		is_open( void );
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size );
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size );
+
+	/** Start batch */
+	void		begin_batch( void );
+
+	/** Issue queued accesses and end batch
+	 * 
+	 * @return	Number of messages issued. Negative value for error
+	 */
+	int			end_batch( void );
+
+protected:
+	/** Issue messages
+	 * 
+	 *	Can be overridden to test without real device
+	 *
+	 * @param msgs	Array of messages
+	 * @param n		Number of messages
+	 * @return	Return value of ioctl()
+	 */
+	virtual int	transfer( struct i2c_msg* msgs, int n );
+
+private:
+	int				fd;
+	bool			own_fd;
+	bool			batching;
+	struct i2c_msg	msg[ MAX_MESSAGES ];
+	int				n_msg;
+	uint8_t			buf[ BATCH_BUFFER ];
+	int				n_buf;
+
+	int				flush( void );
+};
+
+/** LINUX_SPI class
+ *	
+ *  @class LINUX_SPI
+ *
+ *	Transport on /dev/spidevX.Y for SPI devices (GPIO_SPI). 
+ *	Each frame is done by one SPI_IOC_MESSAGE ioctl. 
+ *
+ *	Between begin_batch() and end_batch(), frames are queued and issued by one ioctl. 
+ *	CS is deasserted between frames. 
+ *	A read frame (R/W bit of GPIO_SPI frame is '1') is issued together with queued frames, 
+ *	so its data is available on return. Received data of other frames is discarded. 
+ */
+class LINUX_SPI : public GPIO_TRANSPORT {
+public:
+	/** Maximum number of frames in one ioctl */
+	static constexpr int	MAX_MESSAGES	= 32;
+
+	/** Size of buffer for frames in a batch */
+	static constexpr int	BATCH_BUFFER	= 512;
+
+	/** Constractor
+	 * 
+	 * @param path	Device node path like "/dev/spidev0.0"
+	 * @param speed	SPI clock frequency in Hz
+	 * @param mode	SPI mode
+	 */
+	LINUX_SPI( const char* path, uint32_t speed = 1000000, uint8_t mode = SPI_MODE_0 );
+
+	/** Constractor
+	 * 
+	 * @param fd	File descriptor already opened. It is not closed by this class
+	 * @param speed	SPI clock frequency in Hz
+	 */
+	LINUX_SPI( int fd, uint32_t speed = 1000000 );
+
+	/** Destractor */
+	virtual ~LINUX_SPI();
+
+	/** Check device node
+	 * 
+	 * @return	'true' if the device node is open
+	 */
+	bool		is_open( void );
+
+	/** Not used for SPI. Returns -1 */
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size );
+
+	/** Not used for SPI. Returns -1 */
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size );
+
+	virtual int	txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size );
+
+	/** Sequence of frames by one ioctl
+	 *
+	 *	Received data is stored in 'r_data'. 
+	 *	Queued frames of batch are issued before this sequence. 
+	 */
+	virtual int	txrx_sequence( const uint8_t* w_data, uint8_t* r_data, const uint16_t* sizes, int n );
+
+	/** Start batch */
+	void		begin_batch( void );
+
+	/** Issue queued frames and end batch
+	 * 
+	 * @return	Number of frames issued. Negative value for error
+	 */
+	int			end_batch( void );
+
+protected:
+	/** Issue transfers
+	 * 
+	 *	Can be overridden to test without real device
+	 *
+	 * @param xfer	Array of transfers
+	 * @param n		Number of transfers
+	 * @return	Return value of ioctl()
+	 */
+	virtual int	transfer( struct spi_ioc_transfer* xfer, int n );
+
+private:
+	int							fd;
+	bool						own_fd;
+	uint32_t					hz;
+	bool						batching;
+	struct spi_ioc_transfer		xfer[ MAX_MESSAGES ];
+	int							n_xfer;
+	uint8_t						buf[ BATCH_BUFFER ];
+	int							n_buf;
+
+	int							flush( void );
+};
+
+#endif	//	__linux__ && !ARDUINO
+
+#endif //	ARDUINO_GPIO_NXP_ARD_LINUX_TRANSPORT_H
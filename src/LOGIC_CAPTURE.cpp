@@ -0,0 +1,277 @@
+#include "LOGIC_CAPTURE.h"
+#include "BIT_OPS.h"
+
+LOGIC_CAPTURE::LOGIC_CAPTURE( uint8_t* buffer, int size )
+	: n_devs( 0 ), ring( buffer ), ring_size( size ), head( 0 ), count( 0 ),
+	base_time( 0 ), record_time( 0 ), n_samples( 0 ), start_time( 0 ), end_time( 0 ), n_encoded( 0 ), n_dropped( 0 )
+{
+}
+
+bool LOGIC_CAPTURE::add( GPIO_base& gpio )
+{
+	if ( MAX_DEVICES <= n_devs )
+		return false;
+
+	devs[ n_devs++ ]	= &gpio;
+
+	return true;
+}
+
+bool LOGIC_CAPTURE::begin( void )
+{
+	//	A record must fit in the ring, or record() can't make room for it
+	if ( !ring || (ring_size < MAX_RECORD) )
+		return false;
+
+	for ( int i = 0; i < n_devs; i++ ) {
+		devs[ i ]->read_port( IN, last[ i ] );
+		memcpy( base[ i ], last[ i ], devs[ i ]->n_ports );
+	}
+
+	head		= 0;
+	count		= 0;
+	n_samples	= 0;
+	n_encoded	= 0;
+	n_dropped	= 0;
+	start_time	= micros();
+	end_time	= start_time;
+	base_time	= start_time;
+	record_time	= start_time;
+
+	return true;
+}
+
+bool LOGIC_CAPTURE::sample( void )
+{
+	uint8_t		v[ MAX_DEVICES ][ 8 ];
+	uint32_t	now;
+	bool		changed	= false;
+
+	if ( !ring || (ring_size < MAX_RECORD) )
+		return false;
+
+	//	Read all devices first to keep samples of the devices close in time
+	for ( int i = 0; i < n_devs; i++ )
+		devs[ i ]->read_port( IN, v[ i ] );
+
+	now	= micros();
+
+	for ( int i = 0; i < n_devs; i++ ) {
+		uint8_t	mask	= 0;
+
+		for ( int p = 0; p < devs[ i ]->n_ports; p++ )
+			if ( v[ i ][ p ] != last[ i ][ p ] )
+				mask	|= 1 << p;
+
+		if ( mask ) {
+			record( i, mask, v[ i ], now );
+			memcpy( last[ i ], v[ i ], devs[ i ]->n_ports );
+			changed	= true;
+		}
+	}
+
+	n_samples++;
+	end_time	= now;
+
+	return changed;
+}
+
+uint32_t LOGIC_CAPTURE::capture( uint32_t duration )
+{
+	uint32_t	start	= micros();
+	uint32_t	n		= 0;
+
+	while ( micros() - start < duration ) {
+		sample();
+		n++;
+	}
+
+	return n;
+}
+
+uint32_t LOGIC_CAPTURE::samples( void )
+{
+	return n_samples;
+}
+
+uint32_t LOGIC_CAPTURE::sample_rate( void )
+{
+	uint32_t	t	= end_time - start_time;
+
+	return t ? (uint32_t)((uint64_t)n_samples * 1000000UL / t) : 0;
+}
+
+float LOGIC_CAPTURE::compression_ratio( void )
+{
+	uint32_t	raw	= 4;	//	time stamp
+
+	for ( int i = 0; i < n_devs; i++ )
+		raw	+= devs[ i ]->n_ports;
+
+	return n_encoded ? (float)raw * n_samples / n_encoded : 0.0;
+}
+
+int LOGIC_CAPTURE::used( void )
+{
+	return count;
+}
+
+uint32_t LOGIC_CAPTURE::dropped( void )
+{
+	return n_dropped;
+}
+
+size_t LOGIC_CAPTURE::export_binary( Print& out )
+{
+	size_t	n	= 0;
+	uint8_t	b[ 4 ];
+
+	n	+= out.write( (const uint8_t*)"GLA", 3 );
+	n	+= out.write( (uint8_t)1 );
+	n	+= out.write( (uint8_t)n_devs );
+
+	for ( int i = 0; i < n_devs; i++ )
+		n	+= out.write( (uint8_t)devs[ i ]->n_ports );
+
+	for ( int i = 0; i < 4; i++ )
+		b[ i ]	= base_time >> (i * 8);
+
+	n	+= out.write( b, 4 );
+
+	for ( int i = 0; i < n_devs; i++ )
+		n	+= out.write( base[ i ], devs[ i ]->n_ports );
+
+	for ( int i = 0; i < 4; i++ )
+		b[ i ]	= (uint32_t)count >> (i * 8);
+
+	n	+= out.write( b, 4 );
+
+	for ( int i = 0; i < count; i++ )
+		n	+= out.write( at( i ) );
+
+	return n;
+}
+
+int LOGIC_CAPTURE::pin_streams( int dev, uint32_t period, uint8_t* streams, int n_steps )
+{
+	int			np		= devs[ dev ]->n_ports;
+	int			stride	= (n_steps + 7) / 8;
+	uint8_t		state[ 8 ];
+	uint8_t		snap[ CHUNK * 8 ];
+	uint32_t	now		= 0;
+	int			i		= 0;
+
+	memcpy( state, base[ dev ], np );
+
+	for ( int k = 0; k < n_steps; k++ ) {
+		uint32_t	t	= (uint32_t)k * period;
+
+		//	Apply records up to this time step
+		while ( i < count ) {
+			int			d;
+			uint8_t		mask;
+			uint32_t	dt;
+			int			vi	= parse( i, &d, &mask, &dt );
+
+			if ( t < now + dt )
+				break;
+
+			now	+= dt;
+
+			for ( int p = 0; mask; p++, mask >>= 1 ) {
+				if ( mask & 0x1 ) {
+					if ( d == dev )
+						state[ p ]	= at( vi );
+					vi++;
+				}
+			}
+
+			i	= vi;
+		}
+
+		memcpy( snap + (k % CHUNK) * np, state, np );
+
+		//	Time steps of a chunk are transposed into bytes of pin streams
+		if ( (CHUNK - 1 == k % CHUNK) || (n_steps - 1 == k) )
+			BIT_OPS::ports_to_pins( snap, np, k % CHUNK + 1, streams + (k / CHUNK) * (CHUNK / 8), stride );
+	}
+
+	return n_steps;
+}
+
+void LOGIC_CAPTURE::record( int dev, uint8_t mask, const uint8_t* vp, uint32_t now )
+{
+	uint32_t	dt		= now - record_time;
+	int			size	= 1;
+
+	while ( ring_size - count < MAX_RECORD )
+		n_dropped	+= drop();
+
+	put( (dev << 5) | mask );
+
+	do {
+		put( (dt & 0x7F) | ((0x7F < dt) ? 0x80 : 0x00) );
+		dt	>>= 7;
+		size++;
+	} while ( dt );
+
+	for ( int p = 0; mask; p++, mask >>= 1 ) {
+		if ( mask & 0x1 ) {
+			put( vp[ p ] );
+			size++;
+		}
+	}
+
+	record_time	= now;
+	n_encoded	+= size;
+}
+
+void LOGIC_CAPTURE::put( uint8_t v )
+{
+	ring[ head ]	= v;
+	head			= (head + 1) % ring_size;
+	count++;
+}
+
+uint8_t LOGIC_CAPTURE::at( int index )
+{
+	return ring[ (head - count + index + ring_size) % ring_size ];
+}
+
+int LOGIC_CAPTURE::drop( void )
+{
+	//	Oldest record is applied to the initial state
+	int			dev;
+	uint8_t		mask;
+	uint32_t	dt;
+	int			i	= parse( 0, &dev, &mask, &dt );
+
+	for ( int p = 0; mask; p++, mask >>= 1 )
+		if ( mask & 0x1 )
+			base[ dev ][ p ]	= at( i++ );
+
+	base_time	+= dt;
+	count		-= i;
+
+	return 1;
+}
+
+int LOGIC_CAPTURE::parse( int index, int* dev, uint8_t* mask, uint32_t* dt )
+{
+	uint8_t	h	= at( index++ );
+
+	*dev	= h >> 5;
+	*mask	= h & 0x1F;
+	*dt		= 0;
+
+	for ( int shift = 0; ; shift += 7 ) {
+		uint8_t	b	= at( index++ );
+
+		*dt	|= (uint32_t)(b & 0x7F) << shift;
+
+		if ( !(b & 0x80) )
+			break;
+	}
+
+	return index;
+}
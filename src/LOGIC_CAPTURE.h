@@ -0,0 +1,157 @@
+/** LOGIC_CAPTURE: logic-analyzer style input capture for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_LOGIC_CAPTURE_H
+#define ARDUINO_GPIO_NXP_ARD_LOGIC_CAPTURE_H
+
+#include <GPIO_NXP.h>
+#include <Print.h>
+
+/** LOGIC_CAPTURE class
+ *
+ *  @class LOGIC_CAPTURE
+ *
+ *	Samples IN registers of all ports of devices in back-to-back bursts and 
+ *	stores only changes into a ring buffer given by user. 
+ *	When the ring is full, oldest records are merged into the initial state. 
+ *
+ *	Record format:
+ *	  byte 0	: bit 7~5 = device index, bit 4~0 = mask of changed ports
+ *	  varint	: time from previous record in microseconds (LEB128)
+ *	  bytes		: new values of changed ports, in port order
+ *
+ *	Binary export format (multi-byte values are little endian):
+ *	  "GLA", version(1), number of devices(1), number of ports of each device(1 each), 
+ *	  initial time(4), initial values of all ports, size of records(4), records
+ */
+class LOGIC_CAPTURE {
+public:
+	/** Maximum number of devices */
+	static constexpr int	MAX_DEVICES	= 4;
+
+	/** Maximum size of a record */
+	static constexpr int	MAX_RECORD	= 1 + 5 + 5;
+
+	/** Constractor
+	 *
+	 * @param buffer	Ring buffer
+	 * @param size		Size of the ring buffer. Should be MAX_RECORD or larger, begin() fails otherwise
+	 */
+	LOGIC_CAPTURE( uint8_t* buffer, int size );
+
+	/** Add device to capture
+	 *
+	 * @param gpio	GPIO device instance
+	 * @return	'true' if added
+	 */
+	bool		add( GPIO_base& gpio );
+
+	/** Start capture
+	 *
+	 *	Clears the ring and reads initial state
+	 *
+	 * @return	'false' if the ring buffer is smaller than MAX_RECORD. Nothing is captured in this case
+	 */
+	bool		begin( void );
+
+	/** Take one sample from all devices
+	 *
+	 * @return	'true' if any change was recorded. Always 'false' if the ring is too small
+	 */
+	bool		sample( void );
+
+	/** Capture for a period
+	 *
+	 *	Samples back-to-back at the maximum bus rate
+	 *
+	 * @param duration	Capture period in microseconds
+	 * @return	Number of samples taken
+	 */
+	uint32_t	capture( uint32_t duration );
+
+	/** Number of samples
+	 *
+	 * @return	Number of samples since begin()
+	 */
+	uint32_t	samples( void );
+
+	/** Achieved sample rate
+	 *
+	 * @return	Samples per second
+	 */
+	uint32_t	sample_rate( void );
+
+	/** Compression ratio
+	 *
+	 *	Ratio of raw size (time stamp and all port values for each sample) to encoded size
+	 *
+	 * @return	Compression ratio
+	 */
+	float		compression_ratio( void );
+
+	/** Ring usage
+	 *
+	 * @return	Number of bytes in the ring
+	 */
+	int			used( void );
+
+	/** Number of dropped records
+	 *
+	 * @return	Number of records merged into the initial state by ring overflow
+	 */
+	uint32_t	dropped( void );
+
+	/** Export captured data
+	 *
+	 * @param out	Output stream like Serial
+	 * @return	Number of bytes written
+	 */
+	size_t		export_binary( Print& out );
+
+	/** Resample captured data into pin streams
+	 *
+	 *	States of a device at every 'period' from the initial time are converted into 
+	 *	bit streams of each pin. Format of streams is same as BIT_OPS::ports_to_pins()
+	 *
+	 * @param dev		Device index in order of add()
+	 * @param period	Time step in microseconds
+	 * @param streams	Buffer for pin streams. Should have 'n_ports * 8 * ((n_steps + 7) / 8)' bytes
+	 * @param n_steps	Number of time steps
+	 * @return	Number of time steps written
+	 */
+	int			pin_streams( int dev, uint32_t period, uint8_t* streams, int n_steps );
+
+private:
+	/** Time steps converted by a BIT_OPS::ports_to_pins() call. Multiple of 16 for SIMD path */
+	static constexpr int	CHUNK	= 16;
+
+	GPIO_base*	devs[ MAX_DEVICES ];
+	int			n_devs;
+	uint8_t*	ring;
+	int			ring_size;
+	int			head;
+	int			count;
+
+	uint8_t		last[ MAX_DEVICES ][ 8 ];
+	uint8_t		base[ MAX_DEVICES ][ 8 ];
+	uint32_t	base_time;
+	uint32_t	record_time;
+
+	uint32_t	n_samples;
+	uint32_t	start_time;
+	uint32_t	end_time;
+	uint32_t	n_encoded;
+	uint32_t	n_dropped;
+
+	void		record( int dev, uint8_t mask, const uint8_t* vp, uint32_t now );
+	void		put( uint8_t v );
+	uint8_t		at( int index );
+	int			drop( void );
+	int			parse( int index, int* dev, uint8_t* mask, uint32_t* dt );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_LOGIC_CAPTURE_H
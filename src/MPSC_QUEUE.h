@@ -0,0 +1,110 @@
+/** MPSC_QUEUE: lock-free multi-producer/single-consumer queue for GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_MPSC_QUEUE_H
+#define ARDUINO_GPIO_NXP_ARD_MPSC_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/** MPSC_QUEUE class
+ *	
+ *  @class MPSC_QUEUE
+ *
+ *	Bounded ring buffer which can be used by many producers and one consumer without lock. 
+ *	Each slot has a sequence number to tell the slot is ready for producer or consumer. 
+ *	This needs std::atomic, so it is for host and RTOS targets. 
+ *
+ * @tparam T	Element type
+ * @tparam N	Queue length. Should be power of 2
+ */
+template <class T, int N>
+class MPSC_QUEUE {
+	static_assert( (1 < N) && !(N & (N - 1)), "MPSC_QUEUE length should be power of 2" );
+
+public:
+	MPSC_QUEUE() : tail( 0 ), head( 0 )
+	{
+		for ( int i = 0; i < N; i++ )
+			slot[ i ].seq.store( i, std::memory_order_relaxed );
+	}
+
+	/** Push (producer side, any thread)
+	 *
+	 * @param v	Value to be pushed
+	 * @return	'false' if the queue is full
+	 */
+	bool	push( const T& v )
+	{
+		uint32_t	pos	= tail.load( std::memory_order_relaxed );
+
+		for ( ; ; ) {
+			cell*		cp	= &slot[ pos & (N - 1) ];
+			int32_t		dif	= (int32_t)(cp->seq.load( std::memory_order_acquire ) - pos);
+
+			if ( !dif ) {
+				if ( tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+					cp->value	= v;
+					cp->seq.store( pos + 1, std::memory_order_release );
+					return true;
+				}
+			}
+			else if ( dif < 0 ) {
+				return false;
+			}
+			else {
+				pos	= tail.load( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	/** Pop (consumer side, single thread)
+	 *
+	 * @param vp	Pointer to store popped value
+	 * @return	'false' if the queue is empty
+	 */
+	bool	pop( T* vp )
+	{
+		cell*	cp	= &slot[ head & (N - 1) ];
+
+		if ( (int32_t)(cp->seq.load( std::memory_order_acquire ) - (head + 1)) < 0 )
+			return false;
+
+		*vp	= cp->value;
+		cp->seq.store( head + N, std::memory_order_release );
+		head++;
+
+		return true;
+	}
+
+	/** Peek (consumer side, single thread)
+	 *
+	 * @return	Pointer to the element to be popped next. NULL if the queue is empty
+	 */
+	T*		peek( void )
+	{
+		cell*	cp	= &slot[ head & (N - 1) ];
+
+		if ( (int32_t)(cp->seq.load( std::memory_order_acquire ) - (head + 1)) < 0 )
+			return NULL;
+
+		return &cp->value;
+	}
+
+private:
+	struct cell {
+		std::atomic<uint32_t>	seq;
+		T						value;
+	};
+
+	cell					slot[ N ];
+	std::atomic<uint32_t>	tail;
+	uint32_t				head;
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_MPSC_QUEUE_H
@@ -0,0 +1,154 @@
+#include "MUX_DISPLAY.h"
+
+MUX_DISPLAY::MUX_DISPLAY( GPIO_base& gpio, const uint64_t* select_pins, int rows, uint64_t segment_pins, uint64_t active_low )
+	: dev( gpio ), n_rows( (MAX_ROWS < rows) ? MAX_ROWS : ((rows < 0) ? 0 : rows) ), seg_mask( segment_pins ), invert( active_low ), base( 0 ),
+	valid( false ), swap_req( false ), slot( 0 ), slot_start( 0 ), row( 0 ), blanked( true ),
+	frames( 0 ), rate_start( 0 ), rate_measured( 0 )
+{
+	uint64_t	pins	= seg_mask;
+
+	for ( int i = 0; i < n_rows; i++ ) {
+		select[ i ]	= select_pins[ i ];
+		front[ i ]	= 0;
+		back[ i ]	= 0;
+		duty[ i ]	= 255;
+		pins		|= select[ i ];
+	}
+
+	//	refresh() needs a row and a port to push
+	valid		= n_rows && pins;
+	first_port	= valid ? __builtin_ctzll( pins ) / 8 : 0;
+	n_burst		= valid ? (63 - __builtin_clzll( pins )) / 8 - first_port + 1 : 0;
+	invert		&= pins;
+}
+
+bool MUX_DISPLAY::begin( uint32_t rate_fps )
+{
+	if ( !valid )
+		return false;
+
+	uint64_t	pins	= invert | seg_mask;
+
+	for ( int i = 0; i < n_rows; i++ )
+		pins	|= select[ i ];
+
+	base	= dev.read_image( OUT ) & ~pins;
+	push( 0 );
+	dev.write_image( CONFIG, dev.read_image( CONFIG ) & ~pins );
+
+	rate( rate_fps );
+	row			= n_rows - 1;
+	slot_start	= micros() - slot;
+	rate_start	= micros();
+
+	return true;
+}
+
+void MUX_DISPLAY::rate( uint32_t rate_fps )
+{
+	uint32_t	n	= rate_fps * n_rows;
+
+	slot	= n ? 1000000UL / n : 1000000UL;	//	1 slot per second if rate or rows is 0
+}
+
+void MUX_DISPLAY::brightness( int r, uint8_t d )
+{
+	duty[ r ]	= d;
+}
+
+void MUX_DISPLAY::brightness( uint8_t d )
+{
+	for ( int i = 0; i < n_rows; i++ )
+		duty[ i ]	= d;
+}
+
+void MUX_DISPLAY::set( int r, uint64_t image )
+{
+	back[ r ]	= image & seg_mask;
+}
+
+uint64_t MUX_DISPLAY::get( int r )
+{
+	return back[ r ];
+}
+
+void MUX_DISPLAY::swap( void )
+{
+	swap_req	= true;
+}
+
+bool MUX_DISPLAY::refresh( void )
+{
+	if ( !valid )
+		return false;
+
+	uint32_t	now		= micros();
+	uint32_t	elapsed	= now - slot_start;
+
+	if ( !blanked && (elapsed >= (slot * duty[ row ]) >> 8) && (255 != duty[ row ]) ) {
+		push( 0 );
+		blanked	= true;
+		return true;
+	}
+
+	if ( elapsed < slot )
+		return false;
+
+	slot_start	= (elapsed < 2 * slot) ? slot_start + slot : now;
+
+	if ( n_rows <= ++row ) {
+		row	= 0;
+		frames++;
+
+		if ( swap_req ) {
+			memcpy( front, back, sizeof( front[ 0 ] ) * n_rows );
+			swap_req	= false;
+		}
+
+		if ( 1000000UL <= now - rate_start ) {
+			rate_measured	= (uint32_t)((uint64_t)frames * 1000000UL / (now - rate_start));
+			frames			= 0;
+			rate_start		= now;
+		}
+	}
+
+	if ( duty[ row ] ) {
+		push( select[ row ] | front[ row ] );
+		blanked	= false;
+	}
+	else if ( !blanked ) {
+		push( 0 );
+		blanked	= true;
+	}
+
+	return true;
+}
+
+uint32_t MUX_DISPLAY::achieved_rate( void )
+{
+	return rate_measured;
+}
+
+uint32_t MUX_DISPLAY::max_rate( uint32_t clock )
+{
+	int	writes	= 1;
+
+	for ( int i = 0; i < n_rows; i++ )
+		if ( 255 != duty[ i ] )
+			writes	= 2;
+
+	if ( !valid )
+		return 0;
+
+	uint32_t	t	= dev.bus_time( n_burst, clock ) * writes * n_rows;
+
+	return t ? 1000000UL / t : 0;
+}
+
+void MUX_DISPLAY::push( uint64_t image )
+{
+	uint8_t	b[ 8 ];
+
+	dev.unpack( base | (image ^ invert), b );
+	dev.write_port( OUT, b + first_port, first_port, n_burst );
+}
@@ -0,0 +1,142 @@
+/** MUX_DISPLAY: multiplexed 7-segment / LED matrix refresh engine for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_MUX_DISPLAY_H
+#define ARDUINO_GPIO_NXP_ARD_MUX_DISPLAY_H
+
+#include <GPIO_NXP.h>
+
+/** MUX_DISPLAY class
+ *
+ *  @class MUX_DISPLAY
+ *
+ *	Refresh engine for multiplexed displays.
+ *	Each row (digit) has a select pin and shares segment (column) pins.
+ *	Row select and segment data are pushed in one burst into the OUT registers of ports they are on.
+ *
+ *	Frame image is double-buffered.
+ *	Drawing is done on back buffer and it is shown after swap() at next frame boundary.
+ *
+ *	refresh() should be called frequently from loop() or from a timer task.
+ */
+class MUX_DISPLAY {
+public:
+	/** Maximum number of rows */
+	static constexpr int	MAX_ROWS	= 16;
+
+	/** Constractor
+	 *
+	 * @param gpio			GPIO device instance
+	 * @param select_pins	Array of bit images of row select pins. The array should have 'rows' length
+	 * @param rows			Number of rows
+	 * @param segment_pins	Bit image of segment pins
+	 * @param active_low	Bit image of pins which are active LOW
+	 *
+	 *	'rows' should be 1 or more and pins should be given. 
+	 *	Otherwise the instance is not usable: begin() returns 'false' and refresh() does nothing
+	 */
+	MUX_DISPLAY( GPIO_base& gpio, const uint64_t* select_pins, int rows, uint64_t segment_pins, uint64_t active_low = 0 );
+
+	/** Start refresh
+	 *
+	 *	Pins are configured as output
+	 *
+	 * @param rate	Refresh rate (frames per second)
+	 * @return	'false' if rows or pins given to constructor are invalid
+	 */
+	bool		begin( uint32_t rate = 100 );
+
+	/** Set refresh rate
+	 *
+	 * @param rate	Refresh rate (frames per second)
+	 */
+	void		rate( uint32_t rate );
+
+	/** Set brightness of a row
+	 *
+	 * @param row	Row number
+	 * @param duty	Duty. 0 ~ 255
+	 */
+	void		brightness( int row, uint8_t duty );
+
+	/** Set brightness of all rows
+	 *
+	 * @param duty	Duty. 0 ~ 255
+	 */
+	void		brightness( uint8_t duty );
+
+	/** Set segment data on back buffer
+	 *
+	 * @param row	Row number
+	 * @param image	Bit image of segments to turn on. Bits out of 'segment_pins' are ignored
+	 */
+	void		set( int row, uint64_t image );
+
+	/** Get segment data on back buffer
+	 *
+	 * @param row	Row number
+	 * @return	Bit image of segments
+	 */
+	uint64_t	get( int row );
+
+	/** Show back buffer
+	 *
+	 *	Back buffer is copied to front buffer at next frame boundary
+	 */
+	void		swap( void );
+
+	/** Refresh routine
+	 *
+	 *	Outputs next row when its time slot comes
+	 *
+	 * @return	'true' if a transfer was done
+	 */
+	bool		refresh( void );
+
+	/** Achieved refresh rate
+	 *
+	 * @return	Measured refresh rate (frames per second)
+	 */
+	uint32_t	achieved_rate( void );
+
+	/** Maximum refresh rate
+	 *
+	 *	Estimated refresh rate which the bus can sustain at given bus clock
+	 *
+	 * @param clock	Bus clock frequency in Hz
+	 * @return	Frames per second
+	 */
+	uint32_t	max_rate( uint32_t clock );
+
+private:
+	GPIO_base&	dev;
+	uint64_t	select[ MAX_ROWS ];
+	uint64_t	front[ MAX_ROWS ];
+	uint64_t	back[ MAX_ROWS ];
+	uint8_t		duty[ MAX_ROWS ];
+	int			n_rows;
+	uint64_t	seg_mask;
+	uint64_t	invert;
+	uint64_t	base;
+	int			first_port;
+	int			n_burst;
+	bool		valid;
+	bool		swap_req;
+
+	uint32_t	slot;
+	uint32_t	slot_start;
+	int			row;
+	bool		blanked;
+
+	uint32_t	frames;
+	uint32_t	rate_start;
+	uint32_t	rate_measured;
+
+	void		push( uint64_t image );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_MUX_DISPLAY_H
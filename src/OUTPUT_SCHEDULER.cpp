@@ -0,0 +1,183 @@
+#include "OUTPUT_SCHEDULER.h"
+
+OUTPUT_SCHEDULER::OUTPUT_SCHEDULER( uint32_t slot )
+	: n_devs( 0 ), slot_length( slot ? slot : 1 ), n_events( 0 ), n_xfers( 0 ), next( 0 ), start_time( 0 ),
+	j_max( 0 ), j_min( 0 ), j_sum( 0 ), j_count( 0 )
+{
+}
+
+bool OUTPUT_SCHEDULER::event( GPIO_base& gpio, uint64_t pins, uint64_t values, uint32_t time )
+{
+	int	d;
+
+	if ( MAX_EVENTS <= n_events )
+		return false;
+
+	for ( d = 0; d < n_devs; d++ )
+		if ( devs[ d ] == &gpio )
+			break;
+
+	if ( d == n_devs ) {
+		if ( MAX_DEVICES <= n_devs )
+			return false;
+
+		devs[ n_devs++ ]	= &gpio;
+	}
+
+	//	Insertion keeps time order. Same time events stay in order of addition
+	int	i	= n_events++;
+
+	for ( ; i && (time < events[ i - 1 ].time); i-- )
+		events[ i ]	= events[ i - 1 ];
+
+	events[ i ].dev		= d;
+	events[ i ].time	= time;
+	events[ i ].pins	= pins;
+	events[ i ].values	= values;
+
+	return true;
+}
+
+void OUTPUT_SCHEDULER::clear( void )
+{
+	n_events	= 0;
+	n_xfers		= 0;
+	next		= 0;
+}
+
+int OUTPUT_SCHEDULER::prepare( uint32_t clock )
+{
+	uint64_t	state[ MAX_DEVICES ];
+	uint32_t	bus_free	= 0;
+
+	for ( int d = 0; d < n_devs; d++ )
+		state[ d ]	= devs[ d ]->read_image( OUT );
+
+	n_xfers	= 0;
+	next	= 0;
+
+	for ( int i = 0; i < n_events; ) {
+		uint32_t	slot	= events[ i ].time / slot_length;
+		int			end		= i;
+
+		while ( (end < n_events) && (events[ end ].time / slot_length == slot) )
+			end++;
+
+		//	One burst per device in the slot, on ports between first and last changed ones
+		for ( int d = 0; d < n_devs; d++ ) {
+			uint64_t	image	= state[ d ];
+			uint32_t	target	= 0;
+			bool		found	= false;
+
+			for ( int k = i; k < end; k++ ) {
+				if ( events[ k ].dev != d )
+					continue;
+
+				image	= (image & ~events[ k ].pins) | (events[ k ].values & events[ k ].pins);
+
+				if ( !found )
+					target	= events[ k ].time;
+
+				found	= true;
+			}
+
+			uint64_t	diff	= image ^ state[ d ];
+
+			if ( !diff )
+				continue;
+
+			transfer&	t	= xfers[ n_xfers++ ];
+			uint32_t	issue;
+
+			t.dev		= d;
+			t.first		= __builtin_ctzll( diff ) / 8;
+			t.n			= (63 - __builtin_clzll( diff )) / 8 - t.first + 1;
+			t.target	= target;
+			t.bus		= devs[ d ]->bus_time( t.n, clock );
+
+			devs[ d ]->unpack( image, t.data );
+			memmove( t.data, t.data + t.first, t.n );
+
+			//	Issue early by bus time, but not before previous transfer completes
+			issue	= (t.bus < target) ? target - t.bus : 0;
+			t.issue	= (issue < bus_free) ? bus_free : issue;
+			bus_free	= t.issue + t.bus;
+
+			state[ d ]	= image;
+		}
+
+		i	= end;
+	}
+
+	return n_xfers;
+}
+
+void OUTPUT_SCHEDULER::start( void )
+{
+	next		= 0;
+	j_max		= INT32_MIN;
+	j_min		= INT32_MAX;
+	j_sum		= 0;
+	j_count		= 0;
+	start_time	= micros();
+}
+
+bool OUTPUT_SCHEDULER::run( void )
+{
+	if ( n_xfers <= next )
+		return false;
+
+	if ( micros() - start_time < xfers[ next ].issue )
+		return false;
+
+	return fire();
+}
+
+bool OUTPUT_SCHEDULER::fire( void )
+{
+	if ( n_xfers <= next )
+		return false;
+
+	transfer&	t		= xfers[ next++ ];
+	uint32_t	now		= micros() - start_time;
+	int32_t		jitter	= (int32_t)(now + t.bus - t.target);
+
+	devs[ t.dev ]->write_port( OUT, t.data, t.first, t.n );
+
+	j_max	= (j_max < jitter) ? jitter : j_max;
+	j_min	= (jitter < j_min) ? jitter : j_min;
+	j_sum	+= jitter;
+	j_count++;
+
+	return true;
+}
+
+uint32_t OUTPUT_SCHEDULER::next_time( void )
+{
+	if ( n_xfers <= next )
+		return 0;
+
+	uint32_t	now	= micros() - start_time;
+
+	return (now < xfers[ next ].issue) ? xfers[ next ].issue - now : 0;
+}
+
+bool OUTPUT_SCHEDULER::busy( void )
+{
+	return next < n_xfers;
+}
+
+int32_t OUTPUT_SCHEDULER::max_jitter( void )
+{
+	return j_count ? j_max : 0;
+}
+
+int32_t OUTPUT_SCHEDULER::min_jitter( void )
+{
+	return j_count ? j_min : 0;
+}
+
+int32_t OUTPUT_SCHEDULER::average_jitter( void )
+{
+	return j_count ? j_sum / j_count : 0;
+}
@@ -0,0 +1,147 @@
+/** OUTPUT_SCHEDULER: time-triggered output scheduler for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_OUTPUT_SCHEDULER_H
+#define ARDUINO_GPIO_NXP_ARD_OUTPUT_SCHEDULER_H
+
+#include <GPIO_NXP.h>
+
+/** OUTPUT_SCHEDULER class
+ *
+ *  @class OUTPUT_SCHEDULER
+ *
+ *	Changes outputs at given times from start(). 
+ *	Events are merged per time slot and per device, and prepare() builds a transfer list of 
+ *	OUT register bursts. Each transfer is issued earlier by its modeled bus time (GPIO_base::bus_time()) 
+ *	so that the outputs change at the requested time. 
+ *	run() (or fire() from a timer callback) only sends the pre-built buffers. 
+ *
+ *	Jitter is the difference between modeled output time (issue time + bus time) and the requested time.
+ */
+class OUTPUT_SCHEDULER {
+public:
+	/** Maximum number of devices */
+	static constexpr int	MAX_DEVICES		= 4;
+
+	/** Maximum number of events */
+	static constexpr int	MAX_EVENTS		= 16;
+
+	/** Constractor
+	 *
+	 * @param slot	Slot length in microseconds. Events in a slot are sent together
+	 */
+	OUTPUT_SCHEDULER( uint32_t slot = 100 );
+
+	/** Add an output event
+	 *
+	 *	Events are kept in time order
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param pins		Bit image of pins to change
+	 * @param values	Bit image of new output values
+	 * @param time		Time from start() in microseconds
+	 * @return	'true' if added
+	 */
+	bool		event( GPIO_base& gpio, uint64_t pins, uint64_t values, uint32_t time );
+
+	/** Clear all events */
+	void		clear( void );
+
+	/** Build transfer list
+	 *
+	 *	Current OUT registers of the devices are taken as initial state
+	 *
+	 * @param clock	Bus clock frequency in Hz for bus time model
+	 * @return	Number of transfers
+	 */
+	int			prepare( uint32_t clock );
+
+	/** Start the schedule */
+	void		start( void );
+
+	/** Scheduler routine
+	 *
+	 *	Sends next transfer when its issue time comes. Should be called frequently
+	 *
+	 * @return	'true' if a transfer was sent
+	 */
+	bool		run( void );
+
+	/** Send next transfer now
+	 *
+	 *	For timer callbacks set by next_time()
+	 *
+	 * @return	'true' if a transfer was sent. 'false' if no transfer remains
+	 */
+	bool		fire( void );
+
+	/** Time to next transfer
+	 *
+	 * @return	Microseconds until issue time of next transfer. 0 if it is due or no transfer remains
+	 */
+	uint32_t	next_time( void );
+
+	/** Schedule state
+	 *
+	 * @return	'true' if transfers remain
+	 */
+	bool		busy( void );
+
+	/** Maximum jitter
+	 *
+	 * @return	Largest jitter in microseconds. Positive value is late
+	 */
+	int32_t		max_jitter( void );
+
+	/** Minimum jitter
+	 *
+	 * @return	Smallest jitter in microseconds. Negative value is early
+	 */
+	int32_t		min_jitter( void );
+
+	/** Average jitter
+	 *
+	 * @return	Average of jitter in microseconds
+	 */
+	int32_t		average_jitter( void );
+
+private:
+	struct event_entry {
+		uint8_t		dev;
+		uint32_t	time;
+		uint64_t	pins;
+		uint64_t	values;
+	};
+
+	struct transfer {
+		uint32_t	issue;
+		uint32_t	target;
+		uint16_t	bus;
+		uint8_t		dev;
+		uint8_t		first;
+		uint8_t		n;
+		uint8_t		data[ 8 ];
+	};
+
+	GPIO_base*	devs[ MAX_DEVICES ];
+	int			n_devs;
+	uint32_t	slot_length;
+
+	event_entry	events[ MAX_EVENTS ];
+	int			n_events;
+	transfer	xfers[ MAX_EVENTS ];
+	int			n_xfers;
+	int			next;
+	uint32_t	start_time;
+
+	int32_t		j_max;
+	int32_t		j_min;
+	int32_t		j_sum;
+	int			j_count;
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_OUTPUT_SCHEDULER_H
@@ -0,0 +1,134 @@
+#include "PULSE_COUNTER.h"
+#include "BIT_OPS.h"
+
+#include <string.h>
+#include "INT_LATENCY.h"
+
+PULSE_COUNTER::PULSE_COUNTER( GPIO_base& gpio, uint64_t rising_pins, uint64_t falling_pins )
+	: dev( gpio ), rise( rising_pins ), fall( falling_pins ), last( 0 ), gate( 1000000 ), gate_start( 0 ), gate_elapsed( 0 )
+{
+	clear();
+}
+
+void PULSE_COUNTER::begin( void )
+{
+	uint64_t	pins	= rise | fall;
+
+	dev.write_image( CONFIG, dev.read_image( CONFIG ) | pins );
+
+	if ( dev.has_register( INT_MASK ) )
+		dev.write_image( INT_MASK, dev.read_image( INT_MASK ) & ~pins );
+
+	last		= dev.read_image( IN );
+	gate_start	= micros();
+
+	INT_LATENCY_ADD( &dev );
+}
+
+uint64_t PULSE_COUNTER::service( void )
+{
+	INT_LATENCY_READ_START( &dev );
+
+	uint64_t	now		= dev.read_image( IN );
+
+	INT_LATENCY_READ_END( &dev );
+
+	uint64_t	edges	= (now & ~last & rise) | (~now & last & fall);
+	uint64_t	carry	= edges;
+
+	last	= now;
+
+	//	Ripple carry add of 1 to counters of all edge pins
+	for ( int k = 0; carry && (k < PLANES); k++ ) {
+		uint64_t	t	= plane[ k ] & carry;
+
+		plane[ k ]	^= carry;
+		carry		= t;
+	}
+
+	//	Top plane set means a counter passed half of its range
+	if ( plane[ PLANES - 1 ] )
+		fold();
+
+	if ( edges )
+		INT_LATENCY_DISPATCH( &dev );
+
+	roll_gate();
+
+	return edges;
+}
+
+uint32_t PULSE_COUNTER::count( int pin )
+{
+	if ( (pin < 0) || (MAX_PINS <= pin) )
+		return 0;
+
+	fold();
+	return total[ pin ];
+}
+
+void PULSE_COUNTER::clear( void )
+{
+	memset( plane, 0, sizeof( plane ) );
+	memset( total, 0, sizeof( total ) );
+	memset( total_gate, 0, sizeof( total_gate ) );
+	memset( total_end, 0, sizeof( total_end ) );
+}
+
+float PULSE_COUNTER::frequency( int pin )
+{
+	if ( (pin < 0) || (MAX_PINS <= pin) )
+		return 0.0;
+
+	roll_gate();
+
+	if ( !gate_elapsed )
+		return 0.0;
+
+	return (float)(total_end[ pin ] - total_gate[ pin ]) * 1000000.0 / gate_elapsed;
+}
+
+void PULSE_COUNTER::frequency_gate( uint32_t gate_us )
+{
+	gate	= gate_us;
+}
+
+void PULSE_COUNTER::fold( void )
+{
+	//	8 planes x 8 pins blocks are transposed into 8 bit parts of 8 counters
+	for ( int port = 0; port < MAX_PINS / 8; port++ ) {
+		for ( int g = 0; g < PLANES / 8; g++ ) {
+			uint64_t	x	= 0;
+
+			for ( int k = 0; k < 8; k++ )
+				x	|= ((plane[ g * 8 + k ] >> (port * 8)) & 0xFF) << (k * 8);
+
+			if ( !x )
+				continue;
+
+			x	= BIT_OPS::transpose8( x );
+
+			for ( int j = 0; j < 8; j++ )
+				total[ port * 8 + j ]	+= (uint32_t)((x >> (j * 8)) & 0xFF) << (g * 8);
+		}
+	}
+
+	memset( plane, 0, sizeof( plane ) );
+}
+
+void PULSE_COUNTER::roll_gate( void )
+{
+	uint32_t	now		= micros();
+	uint32_t	elapsed	= now - gate_start;
+
+	if ( elapsed < gate )
+		return;
+
+	//	Counts at start and end of the gate are kept. Frequency is calculated in frequency()
+	fold();
+	memcpy( total_gate, total_end, sizeof( total_gate ) );
+	memcpy( total_end, total, sizeof( total_end ) );
+
+	gate_elapsed	= elapsed;
+	gate_start		= now;
+}
@@ -0,0 +1,103 @@
+/** PULSE_COUNTER: per-pin edge counter and frequency meter for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_PULSE_COUNTER_H
+#define ARDUINO_GPIO_NXP_ARD_PULSE_COUNTER_H
+
+#include <GPIO_NXP.h>
+
+/** PULSE_COUNTER class
+ *
+ *  @class PULSE_COUNTER
+ *
+ *	Counts edges on input pins of a GPIO device.
+ *	service() reads IN of all ports in one burst and finds edges by comparing with previous reading.
+ *	Edges of all pins are added at once into bit-sliced counters: 
+ *	bit 'n' of plane[ k ] is bit 'k' of the counter of pin 'n'. 
+ *	The planes are converted into per-pin counts (by 8x8 bit transpose) only when a gate time passes, 
+ *	a count is read or the planes are going to overflow. 
+ *	Frequencies are calculated from the counts of last gate when frequency() is called.
+ *
+ *	service() should be called when the device INT is asserted. It can be called in polling also. 
+ *	Pulses shorter than the interval of service() calls can be missed.
+ */
+class PULSE_COUNTER {
+public:
+	/** Maximum number of pins */
+	static constexpr int	MAX_PINS	= 40;
+
+	/** Number of bit planes */
+	static constexpr int	PLANES		= 16;
+
+	/** Constractor
+	 *
+	 * @param gpio			GPIO device instance
+	 * @param rising_pins	Bit image of pins to count rising edges
+	 * @param falling_pins	Bit image of pins to count falling edges. A pin can be in both
+	 */
+	PULSE_COUNTER( GPIO_base& gpio, uint64_t rising_pins, uint64_t falling_pins = 0 );
+
+	/** Start counting
+	 *
+	 *	Pins are configured as input and interrupts on those pins are unmasked.
+	 *	Current pin state is taken as initial state.
+	 */
+	void		begin( void );
+
+	/** Service routine
+	 *
+	 *	Reads IN and counts edges of all pins
+	 *
+	 * @return	Bit image of pins which had counted edge
+	 */
+	uint64_t	service( void );
+
+	/** Edge count
+	 *
+	 * @param pin	Pin number
+	 * @return	Number of counted edges. '0' for pin out of range
+	 */
+	uint32_t	count( int pin );
+
+	/** Clear all counts */
+	void		clear( void );
+
+	/** Frequency
+	 *
+	 *	Frequency is measured in gate time given by frequency_gate()
+	 *
+	 * @param pin	Pin number
+	 * @return	Counted edges per second in last gate. '0' for pin out of range
+	 */
+	float		frequency( int pin );
+
+	/** Set gate time for frequency measurement
+	 *
+	 * @param gate_us	Gate time in microseconds
+	 */
+	void		frequency_gate( uint32_t gate_us );
+
+private:
+	GPIO_base&	dev;
+	uint64_t	rise;
+	uint64_t	fall;
+	uint64_t	last;
+	uint64_t	plane[ PLANES ];
+
+	uint32_t	total[ MAX_PINS ];
+	uint32_t	total_gate[ MAX_PINS ];
+	uint32_t	total_end[ MAX_PINS ];
+
+	uint32_t	gate;
+	uint32_t	gate_start;
+	uint32_t	gate_elapsed;
+
+	void		fold( void );
+	void		roll_gate( void );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_PULSE_COUNTER_H
@@ -0,0 +1,149 @@
+#include "QUAD_ENCODER.h"
+#include "INT_LATENCY.h"
+
+QUAD_ENCODER::QUAD_ENCODER( GPIO_base& gpio, uint64_t phase_a_pins )
+	: dev( gpio ), a_pins( 0 ), last( 0 ), n_enc( 0 ), gate( 100000 ), gate_start( 0 )
+{
+	for ( int i = 0; i < 64; i++ )
+		channel[ i ]	= -1;
+
+	for ( int i = 0; i < MAX_ENCODERS; i++ ) {
+		pos[ i ]		= 0;
+		pos_gate[ i ]	= 0;
+		vel[ i ]		= 0;
+		miss[ i ]		= 0;
+	}
+
+	for ( uint64_t m = phase_a_pins; m; m &= m - 1 )
+		add( __builtin_ctzll( m ) );
+}
+
+int QUAD_ENCODER::add( int phase_a )
+{
+	if ( (phase_a < 0) || (63 <= phase_a) || (MAX_ENCODERS <= n_enc) )
+		return -1;
+
+	//	Pins of an encoder can't be shared, since the decoder takes both phases at phase-A bit
+	if ( (a_pins | (a_pins << 1)) & (0x3ULL << phase_a) )
+		return -1;
+
+	a_pins				|= 1ULL << phase_a;
+	channel[ phase_a ]	= n_enc;
+
+	return n_enc++;
+}
+
+void QUAD_ENCODER::begin( void )
+{
+	uint64_t	pins	= a_pins | (a_pins << 1);
+
+	dev.write_image( CONFIG, dev.read_image( CONFIG ) | pins );
+
+	if ( dev.has_register( INT_MASK ) )
+		dev.write_image( INT_MASK, dev.read_image( INT_MASK ) & ~pins );
+
+	last		= dev.read_image( IN );
+	gate_start	= micros();
+
+	INT_LATENCY_ADD( &dev );
+}
+
+uint64_t QUAD_ENCODER::service( void )
+{
+	BUS_LOCK::guard	g( dev.bus_lock() );	//	INT_STATUS and IN are read in one lock
+
+	INT_LATENCY_READ_START( &dev );
+
+	uint64_t	status	= dev.has_register( INT_STATUS ) ? dev.read_image( INT_STATUS ) : 0;
+	uint64_t	now		= dev.read_image( IN );
+
+	INT_LATENCY_READ_END( &dev );
+
+	//	Bit-parallel form of the 16 entry quadrature transition table.
+	//	Each encoder is evaluated at its phase-A bit position
+	uint64_t	a0		= last & a_pins;
+	uint64_t	b0		= (last >> 1) & a_pins;
+	uint64_t	a1		= now & a_pins;
+	uint64_t	b1		= (now >> 1) & a_pins;
+	uint64_t	da		= a0 ^ a1;
+	uint64_t	db		= b0 ^ b1;
+	uint64_t	step	= da ^ db;
+	uint64_t	up		= step & (a1 ^ b0);
+	uint64_t	flag	= (status | (status >> 1)) & a_pins;
+	uint64_t	lost	= (da & db) | (flag & ~(da | db));
+
+	last	= now;
+
+	for ( uint64_t m = step | lost; m; m &= m - 1 ) {
+		uint64_t	bit	= m & -m;
+		int			ch	= channel[ __builtin_ctzll( m ) ];
+
+		if ( bit & lost )
+			miss[ ch ]++;
+		else if ( bit & up )
+			pos[ ch ]++;
+		else
+			pos[ ch ]--;
+	}
+
+	INT_LATENCY_DISPATCH( &dev );
+	roll_gate();
+
+	return step;
+}
+
+int QUAD_ENCODER::count( void )
+{
+	return n_enc;
+}
+
+int32_t QUAD_ENCODER::position( int ch )
+{
+	return pos[ ch ];
+}
+
+void QUAD_ENCODER::position( int ch, int32_t value )
+{
+	pos_gate[ ch ]	+= value - pos[ ch ];
+	pos[ ch ]		= value;
+}
+
+int32_t QUAD_ENCODER::velocity( int ch )
+{
+	roll_gate();
+	return vel[ ch ];
+}
+
+void QUAD_ENCODER::velocity_gate( uint32_t gate_us )
+{
+	gate	= gate_us;
+}
+
+uint32_t QUAD_ENCODER::missed( int ch )
+{
+	return miss[ ch ];
+}
+
+uint32_t QUAD_ENCODER::max_step_rate( uint32_t clock )
+{
+	//	One step per encoder can be resolved in each service() call
+	uint32_t	t	= dev.bus_time( dev.n_ports, clock, true ) * 2;
+
+	return 1000000UL / t;
+}
+
+void QUAD_ENCODER::roll_gate( void )
+{
+	uint32_t	now		= micros();
+	uint32_t	elapsed	= now - gate_start;
+
+	if ( elapsed < gate )
+		return;
+
+	for ( int i = 0; i < n_enc; i++ ) {
+		vel[ i ]		= (int32_t)((int64_t)(pos[ i ] - pos_gate[ i ]) * 1000000 / elapsed);
+		pos_gate[ i ]	= pos[ i ];
+	}
+
+	gate_start	= now;
+}
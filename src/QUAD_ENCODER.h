@@ -0,0 +1,137 @@
+/** QUAD_ENCODER: quadrature rotary encoder decoder for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_QUAD_ENCODER_H
+#define ARDUINO_GPIO_NXP_ARD_QUAD_ENCODER_H
+
+#include <GPIO_NXP.h>
+
+/** QUAD_ENCODER class
+ *
+ *  @class QUAD_ENCODER
+ *
+ *	Decodes multiple quadrature encoders connected to a GPIO device.
+ *	Each encoder uses 2 adjacent pins: phase-A on a pin given by 'phase_a_pins' and phase-B on next (upper) pin.
+ *	All encoders are decoded in parallel with bit operations on whole port image.
+ *
+ *	service() should be called when the device INT is asserted.
+ *	It reads INT_STATUS and IN of all ports and updates positions of all encoders at once.
+ */
+class QUAD_ENCODER {
+public:
+	/** Maximum number of encoders on one device */
+	static constexpr int	MAX_ENCODERS	= 17;
+
+	/** Constractor
+	 *
+	 * @param gpio			GPIO device instance
+	 * @param phase_a_pins	Bit image of phase-A pins. Phase-B pin is next bit of phase-A.
+	 *						Pins are added by add() from lowest. Pins refused by add() are ignored
+	 */
+	QUAD_ENCODER( GPIO_base& gpio, uint64_t phase_a_pins = 0 );
+
+	/** Add encoder
+	 *
+	 *	Should be called before begin(). 
+	 *	Refused if the phase-A or phase-B pin is used by another encoder, 
+	 *	the phase-B pin is out of 64 bit image or MAX_ENCODERS are already added
+	 *
+	 * @param phase_a	Phase-A pin number. Phase-B is next pin
+	 * @return	Channel number of the encoder. -1 if refused
+	 */
+	int			add( int phase_a );
+
+	/** Start decoding
+	 *
+	 *	Encoder pins are configured as input and interrupts on those pins are unmasked.
+	 *	Current pin state is taken as initial state.
+	 */
+	void		begin( void );
+
+	/** Service routine
+	 *
+	 *	Reads INT_STATUS and IN, then updates all encoders.
+	 *	This should be called after the INT pin of device asserted.
+	 *	It can be called in polling also.
+	 *
+	 * @return	Bit image of phase-A pins which had step
+	 */
+	uint64_t	service( void );
+
+	/** Number of encoders
+	 *
+	 * @return	Number of encoders
+	 */
+	int			count( void );
+
+	/** Encoder position
+	 *
+	 * @param ch	Encoder channel. Channels are numbered in order of add()
+	 * @return	Position in quadrature steps
+	 */
+	int32_t		position( int ch );
+
+	/** Set encoder position
+	 *
+	 * @param ch	Encoder channel
+	 * @param value	New position
+	 */
+	void		position( int ch, int32_t value );
+
+	/** Encoder velocity
+	 *
+	 *	Velocity is measured in gate time given by velocity_gate()
+	 *
+	 * @param ch	Encoder channel
+	 * @return	Velocity in steps per second
+	 */
+	int32_t		velocity( int ch );
+
+	/** Set gate time for velocity measurement
+	 *
+	 * @param gate_us	Gate time in microseconds
+	 */
+	void		velocity_gate( uint32_t gate_us );
+
+	/** Missed step count
+	 *
+	 *	Count of transitions which could not be decoded.
+	 *	Both phases changed between 2 readings or a pin had interrupt without level change.
+	 *
+	 * @param ch	Encoder channel
+	 * @return	Missed step count
+	 */
+	uint32_t	missed( int ch );
+
+	/** Maximum step rate
+	 *
+	 *	Estimated step rate which can be followed without missing steps at given bus clock
+	 *
+	 * @param clock	Bus clock frequency in Hz
+	 * @return	Steps per second
+	 */
+	uint32_t	max_step_rate( uint32_t clock );
+
+private:
+	GPIO_base&	dev;
+	uint64_t	a_pins;
+	uint64_t	last;
+	int			n_enc;
+	int8_t		channel[ 64 ];
+
+	int32_t		pos[ MAX_ENCODERS ];
+	int32_t		pos_gate[ MAX_ENCODERS ];
+	int32_t		vel[ MAX_ENCODERS ];
+	uint32_t	miss[ MAX_ENCODERS ];
+
+	uint32_t	gate;
+	uint32_t	gate_start;
+
+	void		roll_gate( void );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_QUAD_ENCODER_H
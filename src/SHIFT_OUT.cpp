@@ -0,0 +1,145 @@
+#include "SHIFT_OUT.h"
+#include "BIT_OPS.h"
+
+SHIFT_OUT::SHIFT_OUT( GPIO_base& gpio, int port_num, uint8_t data_pins, int clock, int latch, bool msb_first )
+	: dev( gpio ), pn( port_num ), data_mask( data_pins ), 
+	clk_bit( ((0 <= clock) && (clock < 8)) ? 1 << clock : 0 ), latch_bit( ((0 <= latch) && (latch < 8)) ? 1 << latch : 0 ),
+	msb( msb_first ), n_ch( __builtin_popcount( data_pins ) ), base( 0 ), n_buf( 0 )
+{
+	//	Clock and latch can't share a pin with data or each other, since every burst drives all of them
+	valid	= clk_bit && !(clk_bit & data_mask) && !(latch_bit & (data_mask | clk_bit)) && (latch < 8);
+
+	uint8_t	pin[ 8 ]	= { 0 };
+	uint8_t	m			= data_pins;
+
+	//	Bit 'c' of a slice is moved to the pin of channel 'c' by two nibble tables
+	for ( int c = 0; m; c++, m &= m - 1 )
+		pin[ c ]	= m & -m;
+
+	for ( int x = 0; x < 16; x++ ) {
+		scatter_lo[ x ]	= 0;
+		scatter_hi[ x ]	= 0;
+
+		for ( int c = 0; c < 4; c++ ) {
+			if ( x & (1 << c) ) {
+				scatter_lo[ x ]	|= pin[ c ];
+				scatter_hi[ x ]	|= pin[ c + 4 ];
+			}
+		}
+	}
+}
+
+bool SHIFT_OUT::begin( void )
+{
+	uint8_t	pins	= data_mask | clk_bit | latch_bit;
+
+	if ( !valid )
+		return false;
+
+	base	= dev.read_port( OUT, pn ) & ~pins;
+
+	dev.output( pn, base );
+	dev.config( pn, dev.read_port( CONFIG, pn ) & ~pins );
+
+	return true;
+}
+
+void SHIFT_OUT::write( const uint8_t* data, int length )
+{
+	if ( !valid )
+		return;
+
+	refresh();
+	send( data, length );
+	pulse();
+}
+
+void SHIFT_OUT::shift( const uint8_t* data, int length )
+{
+	if ( !valid )
+		return;
+
+	refresh();
+	send( data, length );
+}
+
+void SHIFT_OUT::latch( void )
+{
+	if ( !valid )
+		return;
+
+	refresh();
+	pulse();
+}
+
+void SHIFT_OUT::refresh( void )
+{
+	//	Other pins of the port may be changed after begin()
+	base	= dev.read_port( OUT, pn ) & ~(data_mask | clk_bit | latch_bit);
+}
+
+void SHIFT_OUT::send( const uint8_t* data, int length )
+{
+	uint8_t	v	= base;
+
+	for ( int i = 0; i < length; i++ ) {
+		uint64_t	x	= 0;
+
+		for ( int c = 0; c < n_ch; c++ )
+			x	|= (uint64_t)*data++ << (c * 8);
+
+		//	Byte 'j' of transposed matrix is bit 'j' of all channels
+		x	= BIT_OPS::transpose8( x );
+
+		for ( int j = 0; j < 8; j++ ) {
+			uint8_t	s	= x >> ((msb ? 7 - j : j) * 8);
+
+			v	= base | scatter_lo[ s & 0x0F ] | scatter_hi[ s >> 4 ];
+
+			if ( BURST_LENGTH < n_buf + 2 )
+				flush();
+
+			put( v );
+			put( v | clk_bit );
+		}
+	}
+
+	put( v );
+	flush();
+}
+
+void SHIFT_OUT::pulse( void )
+{
+	if ( !latch_bit )
+		return;
+
+	put( base | latch_bit );
+	put( base );
+	flush();
+}
+
+int SHIFT_OUT::channels( void )
+{
+	return n_ch;
+}
+
+uint32_t SHIFT_OUT::bit_rate( uint32_t clock )
+{
+	return (uint32_t)((uint64_t)(BURST_LENGTH / 2) * 1000000UL / dev.bus_time( BURST_LENGTH, clock ));
+}
+
+void SHIFT_OUT::put( uint8_t value )
+{
+	if ( BURST_LENGTH <= n_buf )
+		flush();
+
+	buf[ n_buf++ ]	= value;
+}
+
+void SHIFT_OUT::flush( void )
+{
+	if ( n_buf )
+		dev.write_stream( OUT, buf, n_buf, pn );
+
+	n_buf	= 0;
+}
@@ -0,0 +1,108 @@
+/** SHIFT_OUT: bit-sliced multi-channel serializer over GPIO port, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_SHIFT_OUT_H
+#define ARDUINO_GPIO_NXP_ARD_SHIFT_OUT_H
+
+#include <GPIO_NXP.h>
+
+/** SHIFT_OUT class
+ *
+ *  @class SHIFT_OUT
+ *
+ *	Synchronous serial output for shift register chains (74HC595 or similar) on a port of GPIO device.
+ *	Each data pin is an independent channel and all channels share clock and latch pins.
+ *	Channel bytes are transposed into port images (bit slices) and the images with clock edges 
+ *	are sent by write_stream(). Each bit of all channels takes 2 bytes in one transaction 
+ *	instead of output() calls for each bit of each channel.
+ *
+ *	Other pins of the port keep their output values: OUT register is read at start of each 
+ *	write(), shift() and latch() call and written back with the bursts. 
+ *	A change on the other pins made by another task during a burst may be overwritten. 
+ */
+class SHIFT_OUT {
+public:
+	/** Number of bytes in one burst. Register address and data fit in a Wire buffer. Even for bit pairs */
+	static constexpr int	BURST_LENGTH	= (GPIO_NXP_WIRE_BUFFER - 1) & ~0x1;
+
+	/** Constractor
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param port_num	Port number
+	 * @param data_pins	Bit image of data pins in the port. Channel 0 is the lowest bit
+	 * @param clock		Clock (SHCP) pin bit position. Data is taken at rising edge
+	 * @param latch		Latch (STCP) pin bit position. Set -1 if not used
+	 * @param msb_first	'true' to send MSB first
+	 *
+	 *	Clock and latch pins should not be in 'data_pins' and should be different. 
+	 *	Otherwise the instance is not usable: begin() returns 'false' and nothing is sent
+	 */
+	SHIFT_OUT( GPIO_base& gpio, int port_num, uint8_t data_pins, int clock, int latch = -1, bool msb_first = true );
+
+	/** Initialize
+	 *
+	 *	Pins are configured as output and set LOW
+	 *
+	 * @return	'false' if pin setting given to constructor is invalid
+	 */
+	bool	begin( void );
+
+	/** Shift data and latch
+	 *
+	 * @param data		Channel data. data[ i * channels() + c ] is byte 'i' of channel 'c'
+	 * @param length	Number of bytes of each channel
+	 */
+	void	write( const uint8_t* data, int length );
+
+	/** Shift data without latch
+	 *
+	 * @param data		Channel data. data[ i * channels() + c ] is byte 'i' of channel 'c'
+	 * @param length	Number of bytes of each channel
+	 */
+	void	shift( const uint8_t* data, int length );
+
+	/** Latch pulse */
+	void	latch( void );
+
+	/** Number of channels
+	 *
+	 * @return	Number of data pins
+	 */
+	int		channels( void );
+
+	/** Bit rate
+	 *
+	 *	Estimated bit rate of each channel at given bus clock
+	 *
+	 * @param clock	Bus clock frequency in Hz
+	 * @return	Bits per second
+	 */
+	uint32_t	bit_rate( uint32_t clock );
+
+private:
+	GPIO_base&	dev;
+	int			pn;
+	uint8_t		data_mask;
+	uint8_t		clk_bit;
+	uint8_t		latch_bit;
+	bool		msb;
+	int			n_ch;
+	uint8_t		base;
+	bool		valid;
+	uint8_t		scatter_lo[ 16 ];
+	uint8_t		scatter_hi[ 16 ];
+	uint8_t		buf[ BURST_LENGTH ];
+	int			n_buf;
+
+	void	refresh( void );
+	void	send( const uint8_t* data, int length );
+	void	pulse( void );
+	void	put( uint8_t value );
+	void	flush( void );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_SHIFT_OUT_H
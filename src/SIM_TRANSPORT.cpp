@@ -0,0 +1,180 @@
+#include "SIM_TRANSPORT.h"
+
+#if defined( __linux__ ) && !defined( ARDUINO )
+
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+SIM_TRANSPORT::SIM_TRANSPORT( uint32_t clock, uint32_t overhead )
+	: hz( clock ), oh( overhead ), n_trans( 0 ), t_busy( 0 )
+{
+	memset( regs, 0, sizeof( regs ) );
+}
+
+int SIM_TRANSPORT::reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+{
+	for ( int i = 0; i < size; i++ )
+		regs[ address & 0x7F ][ ((reg & 0x7F) + i) & 0xFF ]	= data[ i ];
+
+	wait( 1 + 9 + 9 + 9 * size + 1 );
+	return size;
+}
+
+int SIM_TRANSPORT::reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+{
+	for ( int i = 0; i < size; i++ )
+		data[ i ]	= regs[ address & 0x7F ][ ((reg & 0x7F) + i) & 0xFF ];
+
+	wait( 1 + 9 + 9 + 1 + 9 + 9 * size + 1 );
+	return size;
+}
+
+int SIM_TRANSPORT::txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+{
+	uint8_t	address	= w_data[ 0 ] >> 1;
+	uint8_t	reg		= w_data[ 1 ];
+
+	for ( int i = 2; i < size; i++ ) {
+		if ( (w_data[ 0 ] & 0x01) && r_data )
+			r_data[ i ]	= regs[ address & 0x7F ][ ((reg & 0x7F) + i - 2) & 0xFF ];
+		else if ( !(w_data[ 0 ] & 0x01) )
+			regs[ address & 0x7F ][ ((reg & 0x7F) + i - 2) & 0xFF ]	= w_data[ i ];
+	}
+
+	wait( 8 * size );
+	return size;
+}
+
+uint8_t SIM_TRANSPORT::peek( uint8_t address, uint8_t reg )
+{
+	return regs[ address & 0x7F ][ reg ];
+}
+
+void SIM_TRANSPORT::poke( uint8_t address, uint8_t reg, uint8_t value )
+{
+	regs[ address & 0x7F ][ reg ]	= value;
+}
+
+uint32_t SIM_TRANSPORT::transactions( void )
+{
+	return n_trans.load( std::memory_order_relaxed );
+}
+
+uint64_t SIM_TRANSPORT::busy_time( void )
+{
+	return t_busy.load( std::memory_order_relaxed );
+}
+
+void SIM_TRANSPORT::wait( uint32_t clocks )
+{
+	uint32_t	us	= oh + (hz ? (uint32_t)((uint64_t)clocks * 1000000 / hz) : 0);
+
+	n_trans.fetch_add( 1, std::memory_order_relaxed );
+	t_busy.fetch_add( us, std::memory_order_relaxed );
+
+	if ( us )
+		std::this_thread::sleep_for( std::chrono::microseconds( us ) );
+}
+
+/* ******** SIM_DMA ******** */
+
+SIM_DMA::SIM_DMA( GPIO_TRANSPORT& bus )
+	: tp( bus ), quit( false ), job( IDLE ), n_transfers( 0 )
+{
+	th	= std::thread( &SIM_DMA::loop, this );
+}
+
+SIM_DMA::~SIM_DMA()
+{
+	{
+		std::lock_guard<std::mutex>	lk( mtx );
+		quit	= true;
+	}
+
+	cv.notify_one();
+	th.join();
+}
+
+bool SIM_DMA::start_write( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size )
+{
+	return start( WRITE, address, reg, data, NULL, size );
+}
+
+bool SIM_DMA::start_read( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size )
+{
+	return start( READ, address, reg, NULL, data, size );
+}
+
+bool SIM_DMA::start_txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+{
+	return start( TXRX, 0, 0, w_data, r_data, size );
+}
+
+uint32_t SIM_DMA::transfers( void )
+{
+	return n_transfers.load();
+}
+
+bool SIM_DMA::start( job_type type, uint8_t address, uint8_t reg, const uint8_t* w_data, uint8_t* r_data, uint16_t size )
+{
+	{
+		std::lock_guard<std::mutex>	lk( mtx );
+
+		if ( IDLE != job )
+			return false;
+
+		job			= type;
+		job_address	= address;
+		job_reg		= reg;
+		job_w		= w_data;
+		job_r		= r_data;
+		job_size	= size;
+	}
+
+	cv.notify_one();
+	return true;
+}
+
+void SIM_DMA::loop( void )
+{
+	std::unique_lock<std::mutex>	lk( mtx );
+
+	for ( ; ; ) {
+		cv.wait( lk, [ this ]{ return quit || (IDLE != job); } );
+
+		if ( IDLE == job )
+			return;
+
+		job_type	type	= job;
+		int			r		= -1;
+
+		lk.unlock();
+
+		switch ( type ) {
+			case WRITE:
+				r	= tp.reg_w( job_address, job_reg, job_w, job_size );
+				break;
+			case READ:
+				r	= tp.reg_r( job_address, job_reg, job_r, job_size );
+				break;
+			case TXRX:
+				r	= tp.txrx( job_w, job_r, job_size );
+				break;
+			default:
+				break;
+		}
+
+		n_transfers.fetch_add( 1 );
+
+		lk.lock();
+		job	= IDLE;
+		lk.unlock();
+
+		complete( r );
+
+		lk.lock();
+	}
+}
+
+#endif	//	__linux__ && !ARDUINO
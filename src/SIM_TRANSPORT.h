@@ -0,0 +1,142 @@
+/** SIM_TRANSPORT: simulated bus transport for GPIO operation library
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_SIM_TRANSPORT_H
+#define ARDUINO_GPIO_NXP_ARD_SIM_TRANSPORT_H
+
+#if defined( __linux__ ) && !defined( ARDUINO )
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "GPIO_TRANSPORT.h"
+#include "DMA_TRANSPORT.h"
+
+/** SIM_TRANSPORT class
+ *	
+ *  @class SIM_TRANSPORT
+ *
+ *	Simulated bus with register files of devices on it, for host test and benchmark. 
+ *	Each access takes time of bus clocks (I2C or SPI frame) and fixed overhead like ioctl. 
+ *	Register address is incremented in a burst, ignoring auto-increment flag. 
+ */
+class SIM_TRANSPORT : public GPIO_TRANSPORT {
+public:
+	/** Constractor
+	 * 
+	 * @param clock		Bus clock frequency in Hz. 0 for no wait
+	 * @param overhead	Overhead per transaction in microseconds
+	 */
+	SIM_TRANSPORT( uint32_t clock = 400000, uint32_t overhead = 0 );
+
+	virtual int	reg_w( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size );
+	virtual int	reg_r( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size );
+
+	/** Full-duplex transfer in GPIO_SPI frame format
+	 *
+	 *	First byte is device address with R/W bit, second byte is register address
+	 */
+	virtual int	txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size );
+
+	/** Register value
+	 * 
+	 * @param address	Target address (7 bit)
+	 * @param reg		Register address
+	 * @return	Register value
+	 */
+	uint8_t		peek( uint8_t address, uint8_t reg );
+
+	/** Set register value without bus access
+	 * 
+	 * @param address	Target address (7 bit)
+	 * @param reg		Register address
+	 * @param value		Register value
+	 */
+	void		poke( uint8_t address, uint8_t reg, uint8_t value );
+
+	/** Number of transactions
+	 * 
+	 * @return	Number of transactions since start
+	 */
+	uint32_t	transactions( void );
+
+	/** Bus busy time
+	 * 
+	 * @return	Total bus time in microseconds since start
+	 */
+	uint64_t	busy_time( void );
+
+private:
+	uint32_t				hz;
+	uint32_t				oh;
+	uint8_t					regs[ 128 ][ 256 ];
+	std::atomic<uint32_t>	n_trans;
+	std::atomic<uint64_t>	t_busy;
+
+	void		wait( uint32_t clocks );
+};
+
+/** SIM_DMA class
+ *	
+ *  @class SIM_DMA
+ *
+ *	Simulated DMA engine for host test of DMA_TRANSPORT. 
+ *	Transfers are done on a thread over given transport (like SIM_TRANSPORT) 
+ *	and completion is notified from the thread as a DMA ISR does. 
+ */
+class SIM_DMA : public DMA_ENGINE {
+public:
+	/** Constractor
+	 * 
+	 * @param bus	Transport which the transfers are done on
+	 */
+	SIM_DMA( GPIO_TRANSPORT& bus );
+
+	/** Destractor */
+	virtual ~SIM_DMA();
+
+	virtual bool	start_write( uint8_t address, uint8_t reg, const uint8_t* data, uint16_t size );
+	virtual bool	start_read( uint8_t address, uint8_t reg, uint8_t* data, uint16_t size );
+	virtual bool	start_txrx( const uint8_t* w_data, uint8_t* r_data, uint16_t size );
+
+	/** Number of transfers
+	 * 
+	 * @return	Number of transfers done since start
+	 */
+	uint32_t		transfers( void );
+
+private:
+	enum job_type {
+		IDLE,
+		WRITE,
+		READ,
+		TXRX,
+	};
+
+	GPIO_TRANSPORT&			tp;
+	std::thread				th;
+	std::mutex				mtx;
+	std::condition_variable	cv;
+	bool					quit;
+	job_type				job;
+	uint8_t					job_address;
+	uint8_t					job_reg;
+	const uint8_t*			job_w;
+	uint8_t*				job_r;
+	uint16_t				job_size;
+	std::atomic<uint32_t>	n_transfers;
+
+	bool	start( job_type type, uint8_t address, uint8_t reg, const uint8_t* w_data, uint8_t* r_data, uint16_t size );
+	void	loop( void );
+};
+
+#endif	//	__linux__ && !ARDUINO
+
+#endif //	ARDUINO_GPIO_NXP_ARD_SIM_TRANSPORT_H
@@ -0,0 +1,82 @@
+/** SPSC_QUEUE: lock-free single-producer/single-consumer queue for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_SPSC_QUEUE_H
+#define ARDUINO_GPIO_NXP_ARD_SPSC_QUEUE_H
+
+#include <stdint.h>
+
+/** SPSC_QUEUE class
+ *	
+ *  @class SPSC_QUEUE
+ *
+ *	Ring buffer which can be used between one producer and one consumer without lock. 
+ *	The producer can be an ISR. 
+ *	Indexes are single byte to be accessed atomically on all targets. 
+ *
+ * @tparam T	Element type
+ * @tparam N	Queue length. Should be power of 2 and 128 or less
+ */
+template <class T, int N>
+class SPSC_QUEUE {
+	static_assert( (0 < N) && (N <= 128) && !(N & (N - 1)), "SPSC_QUEUE length should be power of 2 and 128 or less" );
+
+public:
+	SPSC_QUEUE() : head( 0 ), tail( 0 ) {}
+
+	/** Push (producer side)
+	 *
+	 * @param v	Value to be pushed
+	 * @return	'false' if the queue is full
+	 */
+	bool	push( const T& v )
+	{
+		uint8_t	t	= __atomic_load_n( &tail, __ATOMIC_RELAXED );
+
+		if ( N == (uint8_t)(t - __atomic_load_n( &head, __ATOMIC_ACQUIRE )) )
+			return false;
+
+		buf[ t & (N - 1) ]	= v;
+		__atomic_store_n( &tail, (uint8_t)(t + 1), __ATOMIC_RELEASE );
+
+		return true;
+	}
+
+	/** Pop (consumer side)
+	 *
+	 * @param vp	Pointer to store popped value
+	 * @return	'false' if the queue is empty
+	 */
+	bool	pop( T* vp )
+	{
+		uint8_t	h	= __atomic_load_n( &head, __ATOMIC_RELAXED );
+
+		if ( h == __atomic_load_n( &tail, __ATOMIC_ACQUIRE ) )
+			return false;
+
+		*vp	= buf[ h & (N - 1) ];
+		__atomic_store_n( &head, (uint8_t)(h + 1), __ATOMIC_RELEASE );
+
+		return true;
+	}
+
+	/** Number of elements in the queue
+	 *
+	 * @return	Number of elements
+	 */
+	int		size( void )
+	{
+		return (uint8_t)(__atomic_load_n( &tail, __ATOMIC_ACQUIRE ) - __atomic_load_n( &head, __ATOMIC_ACQUIRE ));
+	}
+
+private:
+	T				buf[ N ];
+	volatile uint8_t	head;
+	volatile uint8_t	tail;
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_SPSC_QUEUE_H
@@ -0,0 +1,224 @@
+#include "STEPPER.h"
+
+//	Speed is in steps per tick, 8.24 fixed point
+#define	ONE_STEP	(1UL << 24)
+
+static const uint8_t	sequence[][ 8 ]	= {
+	{ 0x1, 0x2, 0x4, 0x8, 0x1, 0x2, 0x4, 0x8 },	//	WAVE
+	{ 0x3, 0x6, 0xC, 0x9, 0x3, 0x6, 0xC, 0x9 },	//	FULL
+	{ 0x1, 0x3, 0x2, 0x6, 0x4, 0xC, 0x8, 0x9 },	//	HALF
+};
+
+STEPPER::STEPPER( GPIO_base& gpio, uint32_t tick_us )
+	: dev( gpio ), tick_length( tick_us ), n_motors( 0 ), pins( 0 ), base( 0 ), last( 0 ), tick_start( 0 )
+{
+}
+
+int STEPPER::add( int a, int b, int a_n, int b_n, mode m )
+{
+	if ( MAX_MOTORS <= n_motors )
+		return -1;
+
+	motor&	mt	= motors[ n_motors ];
+
+	mt.coil[ 0 ]	= 1ULL << a;
+	mt.coil[ 1 ]	= 1ULL << b;
+	mt.coil[ 2 ]	= 1ULL << a_n;
+	mt.coil[ 3 ]	= 1ULL << b_n;
+	mt.m			= m;
+	mt.pos			= 0;
+	mt.left			= 0;
+	mt.dir			= 1;
+	mt.phase		= 0;
+	mt.energized	= false;
+	mt.accelerating	= false;
+	mt.v			= 0;
+	mt.acc			= 0;
+	mt.n_accel		= 0;
+
+	pins	|= mt.coil[ 0 ] | mt.coil[ 1 ] | mt.coil[ 2 ] | mt.coil[ 3 ];
+
+	speed( n_motors, 100 );
+
+	return n_motors++;
+}
+
+void STEPPER::begin( void )
+{
+	base	= dev.read_image( OUT ) & ~pins;
+	last	= base;
+
+	dev.write_image( OUT, base );
+	dev.write_image( CONFIG, dev.read_image( CONFIG ) & ~pins );
+
+	tick_start	= micros();
+}
+
+void STEPPER::speed( int mi, uint32_t max, uint32_t accel )
+{
+	motor&	mt	= motors[ mi ];
+	uint64_t	v	= ((uint64_t)max * tick_length << 24) / 1000000UL;
+
+	mt.v_max	= (ONE_STEP < v) ? ONE_STEP : (uint32_t)v;
+	mt.dv		= accel ? (uint32_t)(((uint64_t)accel * tick_length * tick_length << 24) / 1000000000000ULL) : mt.v_max;
+	mt.dv		= mt.dv ? mt.dv : 1;
+}
+
+void STEPPER::move( int mi, int32_t steps )
+{
+	motor&	mt	= motors[ mi ];
+	int8_t	dir	= (steps < 0) ? -1 : 1;
+
+	if ( mt.left && (dir != mt.dir) )
+		return;
+
+	mt.dir			= dir;
+	mt.left			+= (steps < 0) ? -steps : steps;
+	mt.accelerating	= mt.v < mt.v_max;
+}
+
+void STEPPER::stop( int mi )
+{
+	motor&	mt	= motors[ mi ];
+
+	if ( mt.left > mt.n_accel )
+		mt.left	= mt.n_accel;
+}
+
+void STEPPER::release( int mi )
+{
+	motor&	mt	= motors[ mi ];
+
+	//	Next move() starts from standstill with a new acceleration ramp
+	mt.left			= 0;
+	mt.v			= 0;
+	mt.acc			= 0;
+	mt.n_accel		= 0;
+	mt.accelerating	= false;
+	mt.energized	= false;
+}
+
+int32_t STEPPER::position( int mi )
+{
+	return motors[ mi ].pos;
+}
+
+bool STEPPER::busy( int mi )
+{
+	return 0 != motors[ mi ].left;
+}
+
+bool STEPPER::busy( void )
+{
+	for ( int i = 0; i < n_motors; i++ )
+		if ( motors[ i ].left )
+			return true;
+
+	return false;
+}
+
+bool STEPPER::tick( void )
+{
+	for ( int i = 0; i < n_motors; i++ ) {
+		motor&	mt	= motors[ i ];
+
+		if ( !mt.left )
+			continue;
+
+		if ( mt.left <= mt.n_accel ) {
+			mt.accelerating	= false;
+			mt.v			= (mt.dv < mt.v) ? mt.v - mt.dv : mt.dv;
+		}
+		else if ( mt.accelerating ) {
+			mt.v	+= mt.dv;
+
+			if ( mt.v_max <= mt.v ) {
+				mt.v			= mt.v_max;
+				mt.accelerating	= false;
+			}
+		}
+
+		mt.acc	+= mt.v;
+
+		if ( mt.acc < ONE_STEP )
+			continue;
+
+		mt.acc			-= ONE_STEP;
+		mt.phase		= (mt.phase + mt.dir) & 0x7;
+		mt.pos			+= mt.dir;
+		mt.energized	= true;
+
+		if ( mt.accelerating )
+			mt.n_accel++;
+
+		if ( !--mt.left ) {
+			mt.v		= 0;
+			mt.acc		= 0;
+			mt.n_accel	= 0;
+		}
+	}
+
+	uint64_t	img		= image();
+	uint64_t	diff	= img ^ last;
+
+	if ( !diff )
+		return false;
+
+	int		first	= __builtin_ctzll( diff ) / 8;
+	int		n		= (63 - __builtin_clzll( diff )) / 8 - first + 1;
+	uint8_t	b[ 8 ];
+
+	dev.unpack( img, b );
+	dev.write_port( OUT, b + first, first, n );
+	last	= img;
+
+	return true;
+}
+
+bool STEPPER::run( void )
+{
+	uint32_t	now		= micros();
+	uint32_t	elapsed	= now - tick_start;
+
+	if ( elapsed < tick_length )
+		return false;
+
+	tick_start	= (elapsed < 2 * tick_length) ? tick_start + tick_length : now;
+
+	return tick();
+}
+
+uint32_t STEPPER::max_step_rate( uint32_t clock )
+{
+	uint32_t	rate	= 1000000UL / tick_length;
+
+	//	No motor, no transfer
+	if ( !pins )
+		return rate;
+
+	int			first	= __builtin_ctzll( pins ) / 8;
+	int			n		= (63 - __builtin_clzll( pins )) / 8 - first + 1;
+	uint32_t	bus		= 1000000UL / dev.bus_time( n, clock );
+
+	return (bus < rate) ? bus : rate;
+}
+
+uint64_t STEPPER::image( void )
+{
+	uint64_t	img	= base;
+
+	for ( int i = 0; i < n_motors; i++ ) {
+		motor&	mt	= motors[ i ];
+
+		if ( !mt.energized )
+			continue;
+
+		uint8_t	p	= sequence[ mt.m ][ mt.phase ];
+
+		for ( int c = 0; c < 4; c++ )
+			if ( p & (1 << c) )
+				img	|= mt.coil[ c ];
+	}
+
+	return img;
+}
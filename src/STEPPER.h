@@ -0,0 +1,170 @@
+/** STEPPER: unipolar stepper motor phase driver for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_STEPPER_H
+#define ARDUINO_GPIO_NXP_ARD_STEPPER_H
+
+#include <GPIO_NXP.h>
+
+/** STEPPER class
+ *
+ *  @class STEPPER
+ *
+ *	Drives several unipolar stepper motors on a GPIO device. 
+ *	Time is divided into ticks and a motor can take one step in a tick. 
+ *	Phase bits of all motors are merged into one image and it is written only when it changes, 
+ *	in one burst over the changed ports.
+ *
+ *	Speed is a fixed point fraction of steps per tick. Acceleration adds a constant to the speed in each tick 
+ *	and deceleration starts when remaining steps become equal to the steps taken while accelerating, 
+ *	so no division is done in the tick.
+ *
+ *	run() should be called frequently from loop() or tick() from a timer task.
+ */
+class STEPPER {
+public:
+	/** Maximum number of motors */
+	static constexpr int	MAX_MOTORS	= 4;
+
+	/** Phase sequences */
+	enum mode {
+		WAVE,	/**< One phase on */
+		FULL,	/**< Two phases on */
+		HALF,	/**< One and two phases on alternately, half steps */
+	};
+
+	/** Constractor
+	 *
+	 * @param gpio		GPIO device instance
+	 * @param tick_us	Tick length in microseconds
+	 */
+	STEPPER( GPIO_base& gpio, uint32_t tick_us = 1000 );
+
+	/** Add a motor
+	 *
+	 * @param a		Pin number of phase A
+	 * @param b		Pin number of phase B
+	 * @param a_n	Pin number of phase A'
+	 * @param b_n	Pin number of phase B'
+	 * @param m		Phase sequence
+	 * @return	Motor ID. -1 if no space
+	 */
+	int			add( int a, int b, int a_n, int b_n, mode m = FULL );
+
+	/** Start driving
+	 *
+	 *	Pins are configured as output. Motors are not energized until the first step
+	 */
+	void		begin( void );
+
+	/** Set speed profile
+	 *
+	 * @param motor	Motor ID
+	 * @param max	Maximum speed in steps per second. Limited by tick rate
+	 * @param accel	Acceleration in steps per second squared. '0' to start at maximum speed
+	 */
+	void		speed( int motor, uint32_t max, uint32_t accel = 0 );
+
+	/** Move relatively
+	 *
+	 *	Steps are added to remaining steps. Ignored while moving in opposite direction
+	 *
+	 * @param motor	Motor ID
+	 * @param steps	Number of steps. Negative value for reverse
+	 */
+	void		move( int motor, int32_t steps );
+
+	/** Stop with deceleration
+	 *
+	 * @param motor	Motor ID
+	 */
+	void		stop( int motor );
+
+	/** De-energize a motor
+	 *
+	 *	Motion is abandoned. Next move() starts with acceleration from standstill
+	 *
+	 * @param motor	Motor ID
+	 */
+	void		release( int motor );
+
+	/** Motor position
+	 *
+	 * @param motor	Motor ID
+	 * @return	Position in steps
+	 */
+	int32_t		position( int motor );
+
+	/** Motor state
+	 *
+	 * @param motor	Motor ID
+	 * @return	'true' if moving
+	 */
+	bool		busy( int motor );
+
+	/** Any motor state
+	 *
+	 * @return	'true' if any motor is moving
+	 */
+	bool		busy( void );
+
+	/** Tick routine
+	 *
+	 *	Advances all motors by one tick
+	 *
+	 * @return	'true' if a transfer was done
+	 */
+	bool		tick( void );
+
+	/** Scheduler routine
+	 *
+	 *	Calls tick() when its time comes
+	 *
+	 * @return	'true' if a transfer was done
+	 */
+	bool		run( void );
+
+	/** Maximum step rate
+	 *
+	 *	Step rate which the bus can sustain at given bus clock, limited by tick rate. 
+	 *	Tick rate is returned if no motor is added
+	 *
+	 * @param clock	Bus clock frequency in Hz
+	 * @return	Steps per second
+	 */
+	uint32_t	max_step_rate( uint32_t clock );
+
+private:
+	struct motor {
+		uint64_t	coil[ 4 ];
+		mode		m;
+		int32_t		pos;
+		uint32_t	left;
+		int8_t		dir;
+		uint8_t		phase;
+		bool		energized;
+		bool		accelerating;
+		uint32_t	v;
+		uint32_t	v_max;
+		uint32_t	dv;
+		uint32_t	acc;
+		uint32_t	n_accel;
+	};
+
+	GPIO_base&	dev;
+	uint32_t	tick_length;
+	motor		motors[ MAX_MOTORS ];
+	int			n_motors;
+	uint64_t	pins;
+	uint64_t	base;
+	uint64_t	last;
+	uint32_t	tick_start;
+
+	uint64_t	image( void );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_STEPPER_H
@@ -0,0 +1,124 @@
+#include "WAVE_PLAYER.h"
+
+WAVE_PLAYER::WAVE_PLAYER( GPIO_base& gpio, const uint8_t* table, int records, int first_port, int n_ports )
+	: dev( gpio ), tp( table ), n_records( records ), first( first_port ), n( n_ports ),
+	index( 0 ), loop_count( 1 ), loops_left( 0 ), playing( false ), armed( false ), trig_pins( 0 ), trig_level( 0 ),
+	last( 0 ), wait( 0 )
+{
+}
+
+void WAVE_PLAYER::begin( void )
+{
+	for ( int i = 0; i < n; i++ ) {
+		uint8_t	pins	= 0;
+
+		for ( int r = 0; r < n_records; r++ )
+			pins	|= pgm_read_byte( tp + r * (2 + n) + 2 + i );
+
+		if ( pins )
+			dev.config( first + i, dev.read_port( CONFIG, first + i ) & ~pins );
+	}
+}
+
+void WAVE_PLAYER::start( int loops )
+{
+	index		= 0;
+	loop_count	= loops;
+	loops_left	= loops;
+	wait		= 0;
+	last		= micros();
+	playing		= 0 < n_records;
+	armed		= false;
+}
+
+void WAVE_PLAYER::arm( uint64_t pins, uint64_t level, int loops )
+{
+	trig_pins	= pins;
+	trig_level	= level & pins;
+	loop_count	= loops;
+	playing		= false;
+	armed		= true;
+}
+
+void WAVE_PLAYER::stop( void )
+{
+	playing	= false;
+	armed	= false;
+}
+
+bool WAVE_PLAYER::run( void )
+{
+	if ( !playing ) {
+		if ( !armed )
+			return false;
+
+		if ( (dev.read_image( IN ) & trig_pins) != trig_level )
+			return true;
+
+		start( loop_count );
+	}
+
+	uint32_t	now		= micros();
+	uint32_t	elapsed	= now - last;
+
+	if ( elapsed < wait )
+		return true;
+
+	//	Keep record timing on schedule unless it is behind more than a record
+	last	= (elapsed < 2 * wait) ? last + wait : now;
+
+	if ( 1 == n ) {
+		int	n_buf	= 0;
+
+		do {
+			wait	= fetch( buf + n_buf++ );
+		} while ( playing && !wait && (n_buf < BURST_LENGTH) );
+
+		dev.write_stream( OUT, buf, n_buf, first );
+	}
+	else {
+		wait	= fetch( buf );
+		dev.write_port( OUT, buf, first, n );
+	}
+
+	return playing;
+}
+
+void WAVE_PLAYER::play( int loops )
+{
+	start( loops );
+
+	while ( run() )
+		;
+}
+
+bool WAVE_PLAYER::busy( void )
+{
+	return playing;
+}
+
+uint32_t WAVE_PLAYER::max_rate( uint32_t clock )
+{
+	if ( 1 == n )
+		return (uint32_t)((uint64_t)BURST_LENGTH * 1000000UL / dev.bus_time( BURST_LENGTH, clock ));
+
+	return 1000000UL / dev.bus_time( n, clock );
+}
+
+uint16_t WAVE_PLAYER::fetch( uint8_t* vp )
+{
+	const uint8_t*	rp	= tp + index * (2 + n);
+	uint16_t		d	= pgm_read_byte( rp ) | (pgm_read_byte( rp + 1 ) << 8);
+
+	for ( int i = 0; i < n; i++ )
+		vp[ i ]	= pgm_read_byte( rp + 2 + i );
+
+	if ( n_records <= ++index ) {
+		index	= 0;
+
+		if ( loop_count && !--loops_left )
+			playing	= false;
+	}
+
+	return d;
+}
@@ -0,0 +1,123 @@
+/** WAVE_PLAYER: digital waveform playback from flash tables for GPIO operation library, Arduino
+ *
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef ARDUINO_GPIO_NXP_ARD_WAVE_PLAYER_H
+#define ARDUINO_GPIO_NXP_ARD_WAVE_PLAYER_H
+
+#include <GPIO_NXP.h>
+
+#ifndef pgm_read_byte
+#define pgm_read_byte( p )	(*(const uint8_t*)(p))
+#endif
+
+/** WAVE_PLAYER class
+ *
+ *  @class WAVE_PLAYER
+ *
+ *	Plays a table of (delay, port image) records through OUT registers of consecutive ports. 
+ *	The table can be in PROGMEM. It is read record by record, so RAM usage doesn't depend on the table length. 
+ *
+ *	Record format (delay is little endian):
+ *	  delay(2)	: time to next record in microseconds. '0' means the next record follows as fast as the bus allows
+ *	  image		: 'n_ports' bytes of port values
+ *
+ *	Single port tables send runs of '0' delay records with write_stream() (repeated writes into same register). 
+ *	Multiple port tables send each record by a write_port() burst.
+ */
+class WAVE_PLAYER {
+public:
+	/** Number of bytes in one stream burst. Register address and data fit in a Wire buffer */
+	static constexpr int	BURST_LENGTH	= GPIO_NXP_WIRE_BUFFER - 1;
+
+	/** Constractor
+	 *
+	 * @param gpio			GPIO device instance
+	 * @param table			Record table. Can be in PROGMEM
+	 * @param records		Number of records
+	 * @param first_port	First port number of images
+	 * @param n_ports		Number of ports in an image
+	 */
+	WAVE_PLAYER( GPIO_base& gpio, const uint8_t* table, int records, int first_port = 0, int n_ports = 1 );
+
+	/** Configure the pins driven by the table as output
+	 *
+	 *	Pins which are HIGH in any record are set to output. 
+	 *	Configuration of other pins is not changed
+	 */
+	void		begin( void );
+
+	/** Start playback
+	 *
+	 * @param loops	Number of times to play the table. '0' for endless
+	 */
+	void		start( int loops = 1 );
+
+	/** Start playback by trigger
+	 *
+	 *	Playback starts in run() when (IN image & pins) == level
+	 *
+	 * @param pins	Bit image of trigger pins
+	 * @param level	Bit image of trigger levels
+	 * @param loops	Number of times to play the table. '0' for endless
+	 */
+	void		arm( uint64_t pins, uint64_t level, int loops = 1 );
+
+	/** Stop playback */
+	void		stop( void );
+
+	/** Playback routine
+	 *
+	 *	Outputs next record(s) when the time comes. Should be called frequently
+	 *
+	 * @return	'true' if playing or waiting for trigger
+	 */
+	bool		run( void );
+
+	/** Blocking playback
+	 *
+	 *	Calls run() until the end of playback
+	 *
+	 * @param loops	Number of times to play the table
+	 */
+	void		play( int loops = 1 );
+
+	/** Playback state
+	 *
+	 * @return	'true' if playing
+	 */
+	bool		busy( void );
+
+	/** Maximum record rate
+	 *
+	 *	Estimated rate of '0' delay records at given bus clock
+	 *
+	 * @param clock	Bus clock frequency in Hz
+	 * @return	Records per second
+	 */
+	uint32_t	max_rate( uint32_t clock );
+
+private:
+	GPIO_base&		dev;
+	const uint8_t*	tp;
+	int				n_records;
+	int				first;
+	int				n;
+	int				index;
+	int				loop_count;
+	int				loops_left;
+	bool			playing;
+	bool			armed;
+	uint64_t		trig_pins;
+	uint64_t		trig_level;
+	uint32_t		last;
+	uint32_t		wait;
+	uint8_t			buf[ BURST_LENGTH ];
+
+	uint16_t	fetch( uint8_t* vp );
+};
+
+#endif //	ARDUINO_GPIO_NXP_ARD_WAVE_PLAYER_H